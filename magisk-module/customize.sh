@@ -0,0 +1,29 @@
+# Runs once at install time (Magisk / KernelSU installer, as root).
+# The audit log and bridge.conf live where system_server (uid 1000) can write: /data/adb is
+# root-only, so use a system-owned directory under /data/system (SELinux type system_data_file).
+BRIDGE_DATA_DIR=/data/system/murasaki_bridge
+
+mkdir -p "$BRIDGE_DATA_DIR"
+set_perm "$BRIDGE_DATA_DIR" 1000 1000 0700 u:object_r:system_data_file:s0
+if [ -f "$BRIDGE_DATA_DIR/bridge.conf" ]; then
+  set_perm "$BRIDGE_DATA_DIR/bridge.conf" 1000 1000 0600 u:object_r:system_data_file:s0
+fi
+ui_print "- Bridge data directory: $BRIDGE_DATA_DIR"
+
+# Audit log reader for this device's ABI (build.sh packs one per ABI under bin/)
+case "$ARCH" in
+  arm64) AUDIT_ABI=arm64-v8a ;;
+  arm)   AUDIT_ABI=armeabi-v7a ;;
+  x64)   AUDIT_ABI=x86_64 ;;
+  x86)   AUDIT_ABI=x86 ;;
+  *)     AUDIT_ABI= ;;
+esac
+if [ -n "$AUDIT_ABI" ] && [ -f "$MODPATH/bin/$AUDIT_ABI/murasaki_audit" ]; then
+  mkdir -p "$MODPATH/system/bin"
+  mv "$MODPATH/bin/$AUDIT_ABI/murasaki_audit" "$MODPATH/system/bin/murasaki_audit"
+  set_perm "$MODPATH/system/bin/murasaki_audit" 0 2000 0755
+  ui_print "- Audit log reader: /system/bin/murasaki_audit"
+else
+  ui_print "! No murasaki_audit for $ARCH"
+fi
+rm -rf "$MODPATH/bin"
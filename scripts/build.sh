@@ -5,6 +5,7 @@ ROOT_DIR="$(cd "$(dirname "$0")/.." && pwd)"
 SRC_DIR="$ROOT_DIR/userspace/zygisk_murasaki_bridge"
 OUT_MOD_DIR="$ROOT_DIR/magisk-module"
 OUT_ZYGISK_DIR="$OUT_MOD_DIR/zygisk"
+OUT_BIN_DIR="$OUT_MOD_DIR/bin"
 
 : "${ANDROID_NDK_HOME:?ANDROID_NDK_HOME is not set}"
 
@@ -36,9 +37,15 @@ build_one() {
 
   "$PREBUILT/bin/llvm-strip" -s "$build_dir/libmurasaki_zygisk_bridge.so"
   cp "$build_dir/libmurasaki_zygisk_bridge.so" "$OUT_ZYGISK_DIR/$abi.so"
+
+  # Audit log reader; customize.sh installs the device's ABI as /system/bin/murasaki_audit
+  "$PREBUILT/bin/llvm-strip" -s "$build_dir/murasaki_audit"
+  mkdir -p "$OUT_BIN_DIR/$abi"
+  cp "$build_dir/murasaki_audit" "$OUT_BIN_DIR/$abi/murasaki_audit"
 }
 
 mkdir -p "$OUT_ZYGISK_DIR"
+rm -rf "$OUT_BIN_DIR"
 
 build_one arm64-v8a aarch64-linux-android29
 build_one armeabi-v7a armv7a-linux-androideabi29
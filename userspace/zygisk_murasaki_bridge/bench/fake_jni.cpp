@@ -0,0 +1,769 @@
+#include "fake_jni.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace murasaki::bench {
+
+namespace {
+
+using NativeInterface = std::remove_const_t<std::remove_pointer_t<decltype(JNIEnv::functions)>>;
+using InvokeInterface = std::remove_const_t<std::remove_pointer_t<decltype(JavaVM::functions)>>;
+
+constexpr const char* kAmsDescriptor = "android.app.IActivityManager";
+constexpr const char* kMurasakiService = "io.murasaki.IMurasakiService";
+constexpr const char* kShizukuService = "user_service";
+constexpr const char* kShizukuPermission = "moe.shizuku.manager.permission.API_V23";
+constexpr jint kTxIsUidGrantedRoot = 11;
+constexpr jint kTxGetUidsGrantedRoot = 1 + 1000;
+constexpr jint kTxGetInterfaceVersion = 0x00ffffff;
+constexpr jint kGetPermissions = 0x1000;
+constexpr jint kGetMetaData = 0x80;
+
+enum class Kind : uint8_t {
+    Class,
+    String,
+    Parcel,
+    Binder,
+    Array,
+    IntArray,
+    PackageInfo,
+    AppInfo,
+    Bundle,
+    ActivityThread,
+    Context,
+    PackageManager,
+    Intent,
+};
+
+struct Obj;
+
+struct ParcelEntry {
+    enum Type : uint8_t { Int, Str, Binder } type = Int;
+    int32_t i = 0;
+    std::string s;
+    Obj* binder = nullptr;
+};
+
+struct Obj {
+    explicit Obj(Kind k) : kind(k) {}
+    Kind kind;
+    bool permanent = false;
+    bool pinned = false;
+    std::string str;                  // String value, class name or service name
+    std::vector<Obj*> elems;          // Array / PackageInfo.requestedPermissions
+    std::vector<int32_t> ints;        // IntArray
+    std::vector<ParcelEntry> parcel;  // Parcel contents
+    size_t pos = 0;                   // Parcel read position (entry index)
+    int uid = -1;                     // owner of PackageInfo/ApplicationInfo
+    std::atomic<bool> alive{true};    // Binder: remote process still running
+    std::atomic<bool> obituary{false};  // Binder proxy saw the death (failed call); isBinderAlive reports it
+};
+
+enum class M : uint8_t {
+    Binder_getCallingUid,
+    Binder_getCallingPid,
+    Parcel_obtainPtr,
+    Parcel_obtain,
+    Parcel_recycle,
+    Parcel_setDataPosition,
+    Parcel_enforceInterface,
+    Parcel_readInt,
+    Parcel_readByte,
+    Parcel_readString,
+    Parcel_writeInterfaceToken,
+    Parcel_writeInt,
+    Parcel_writeNoException,
+    Parcel_writeStrongBinder,
+    Parcel_readException,
+    Parcel_dataAvail,
+    Parcel_writeIntArray,
+    Parcel_createIntArray,
+    SM_getService,
+    IBinder_transact,
+    IBinder_pingBinder,
+    IBinder_isBinderAlive,
+    AT_currentActivityThread,
+    AT_getSystemContext,
+    Context_getPackageManager,
+    Context_startActivity,
+    PM_getPackagesForUid,
+    PM_getPackageInfo,
+    PM_getApplicationInfo,
+    Bundle_getBoolean,
+    String_startsWith,
+    Intent_init,
+    Intent_setClassName,
+    Intent_putExtra_SS,
+    Intent_putExtra_SI,
+    Intent_addFlags,
+    Count,
+};
+
+struct MethodDesc {
+    const char* cls;
+    const char* name;
+    const char* sig;
+};
+
+const MethodDesc kMethods[] = {
+    {"android/os/Binder", "getCallingUid", "()I"},
+    {"android/os/Binder", "getCallingPid", "()I"},
+    {"android/os/Parcel", "obtain", "(J)Landroid/os/Parcel;"},
+    {"android/os/Parcel", "obtain", "()Landroid/os/Parcel;"},
+    {"android/os/Parcel", "recycle", "()V"},
+    {"android/os/Parcel", "setDataPosition", "(I)V"},
+    {"android/os/Parcel", "enforceInterface", "(Ljava/lang/String;)V"},
+    {"android/os/Parcel", "readInt", "()I"},
+    {"android/os/Parcel", "readByte", "()B"},
+    {"android/os/Parcel", "readString", "()Ljava/lang/String;"},
+    {"android/os/Parcel", "writeInterfaceToken", "(Ljava/lang/String;)V"},
+    {"android/os/Parcel", "writeInt", "(I)V"},
+    {"android/os/Parcel", "writeNoException", "()V"},
+    {"android/os/Parcel", "writeStrongBinder", "(Landroid/os/IBinder;)V"},
+    {"android/os/Parcel", "readException", "()V"},
+    {"android/os/Parcel", "dataAvail", "()I"},
+    {"android/os/Parcel", "writeIntArray", "([I)V"},
+    {"android/os/Parcel", "createIntArray", "()[I"},
+    {"android/os/ServiceManager", "getService", "(Ljava/lang/String;)Landroid/os/IBinder;"},
+    {"android/os/IBinder", "transact", "(ILandroid/os/Parcel;Landroid/os/Parcel;I)Z"},
+    {"android/os/IBinder", "pingBinder", "()Z"},
+    {"android/os/IBinder", "isBinderAlive", "()Z"},
+    {"android/app/ActivityThread", "currentActivityThread", "()Landroid/app/ActivityThread;"},
+    {"android/app/ActivityThread", "getSystemContext", "()Landroid/content/Context;"},
+    {"android/content/Context", "getPackageManager", "()Landroid/content/pm/PackageManager;"},
+    {"android/content/Context", "startActivity", "(Landroid/content/Intent;)V"},
+    {"android/content/pm/PackageManager", "getPackagesForUid", "(I)[Ljava/lang/String;"},
+    {"android/content/pm/PackageManager", "getPackageInfo", "(Ljava/lang/String;I)Landroid/content/pm/PackageInfo;"},
+    {"android/content/pm/PackageManager", "getApplicationInfo",
+     "(Ljava/lang/String;I)Landroid/content/pm/ApplicationInfo;"},
+    {"android/os/Bundle", "getBoolean", "(Ljava/lang/String;Z)Z"},
+    {"java/lang/String", "startsWith", "(Ljava/lang/String;)Z"},
+    {"android/content/Intent", "<init>", "()V"},
+    {"android/content/Intent", "setClassName", "(Ljava/lang/String;Ljava/lang/String;)Landroid/content/Intent;"},
+    {"android/content/Intent", "putExtra", "(Ljava/lang/String;Ljava/lang/String;)Landroid/content/Intent;"},
+    {"android/content/Intent", "putExtra", "(Ljava/lang/String;I)Landroid/content/Intent;"},
+    {"android/content/Intent", "addFlags", "(I)Landroid/content/Intent;"},
+};
+static_assert(sizeof(kMethods) / sizeof(kMethods[0]) == static_cast<size_t>(M::Count), "method table out of sync");
+
+enum class F : uint8_t {
+    PM_GET_PERMISSIONS = 1,
+    PM_GET_META_DATA,
+    PackageInfo_requestedPermissions,
+    ApplicationInfo_metaData,
+};
+
+const char* const kClassNames[] = {
+    "android/os/Binder",
+    "android/os/Parcel",
+    "android/os/ServiceManager",
+    "android/os/IBinder",
+    "android/app/ActivityThread",
+    "android/content/Context",
+    "android/content/pm/PackageManager",
+    "android/content/pm/PackageInfo",
+    "android/content/pm/ApplicationInfo",
+    "android/os/Bundle",
+    "java/lang/String",
+    "android/content/Intent",
+};
+
+WorldConfig g_config;
+WorldStats g_stats;
+NativeInterface g_table{};
+InvokeInterface g_vm_table{};
+JavaVM g_vm{};
+
+std::unordered_map<std::string, Obj*> g_classes;
+Obj* g_activity_thread = nullptr;
+Obj* g_context = nullptr;
+Obj* g_pm = nullptr;
+std::atomic<Obj*> g_daemon_binder{nullptr};  // replaced on restart, like a re-registered service
+Obj* g_shizuku_binder = nullptr;
+Obj* g_stub_binder = nullptr;
+
+thread_local int t_uid = 10000;
+thread_local int t_pid = 1000;
+thread_local bool t_pending = false;
+thread_local std::vector<Obj*> t_arena;
+
+void sleep_us(uint32_t us) {
+    if (us) std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+Obj* permanent(Kind kind, const char* str = "") {
+    Obj* o = new Obj(kind);
+    o->permanent = true;
+    o->pinned = true;
+    o->str = str;
+    return o;
+}
+
+Obj* local(Kind kind) {
+    Obj* o = new Obj(kind);
+    t_arena.push_back(o);
+    return o;
+}
+
+Obj* local_string(const std::string& s) {
+    Obj* o = local(Kind::String);
+    o->str = s;
+    return o;
+}
+
+inline Obj* O(jobject o) {
+    return reinterpret_cast<Obj*>(o);
+}
+
+inline jobject J(Obj* o) {
+    return reinterpret_cast<jobject>(o);
+}
+
+bool declared(int uid) {
+    return g_config.is_declared ? g_config.is_declared(uid) : true;
+}
+
+bool granted(int uid) {
+    return g_config.is_granted ? g_config.is_granted(uid) : true;
+}
+
+ParcelEntry* next_entry(Obj* p, ParcelEntry::Type type) {
+    if (!p || p->pos >= p->parcel.size() || p->parcel[p->pos].type != type) {
+        return nullptr;
+    }
+    return &p->parcel[p->pos++];
+}
+
+void push_int(Obj* p, int32_t v) {
+    ParcelEntry e;
+    e.type = ParcelEntry::Int;
+    e.i = v;
+    p->parcel.push_back(std::move(e));
+}
+
+void push_str(Obj* p, const std::string& s) {
+    ParcelEntry e;
+    e.type = ParcelEntry::Str;
+    e.s = s;
+    p->parcel.push_back(std::move(e));
+}
+
+// Like BpBinder: a call on a dead remote fails and marks the proxy dead. Nothing else does, since
+// the bridge never links to death on host. transact() then throws DeadObjectException.
+bool check_alive(Obj* binder) {
+    if (binder->alive.load(std::memory_order_relaxed)) return true;
+    binder->obituary.store(true, std::memory_order_relaxed);
+    return false;
+}
+
+jboolean binder_transact(Obj* binder, jint code, Obj* data, Obj* reply) {
+    if (!check_alive(binder)) {
+        t_pending = true;
+        return JNI_FALSE;
+    }
+    if (binder != g_daemon_binder) return JNI_FALSE;
+    g_stats.daemon_calls.fetch_add(1, std::memory_order_relaxed);
+    data->pos = 0;
+    if (code == kTxIsUidGrantedRoot) {
+        next_entry(data, ParcelEntry::Str);
+        ParcelEntry* uid = next_entry(data, ParcelEntry::Int);
+        uint32_t extra_us = uid && g_config.daemon_extra_us ? g_config.daemon_extra_us(uid->i) : 0;
+        sleep_us(g_config.daemon_call_us + extra_us);
+        push_int(reply, 0);  // no exception
+        push_int(reply, uid && granted(uid->i) ? 1 : 0);
+        return JNI_TRUE;
+    }
+    if (code == kTxGetInterfaceVersion && g_config.daemon_bulk_query) {
+        sleep_us(g_config.daemon_call_us);
+        push_int(reply, 0);  // no exception
+        push_int(reply, 2);  // first interface version with getUidsGrantedRoot
+        return JNI_TRUE;
+    }
+    if (code == kTxGetUidsGrantedRoot && g_config.daemon_bulk_query) {
+        next_entry(data, ParcelEntry::Str);
+        ParcelEntry* count = next_entry(data, ParcelEntry::Int);
+        std::vector<int32_t> bits(count ? (count->i + 31) / 32 : 0);
+        uint32_t extra_us = 0;
+        for (int32_t i = 0; count && i < count->i; ++i) {
+            ParcelEntry* uid = next_entry(data, ParcelEntry::Int);
+            if (!uid) break;
+            if (g_config.daemon_extra_us) extra_us += g_config.daemon_extra_us(uid->i);
+            if (granted(uid->i)) bits[i / 32] |= static_cast<int32_t>(1u << (i % 32));
+        }
+        sleep_us(g_config.daemon_call_us + extra_us);
+        push_int(reply, 0);  // no exception
+        push_int(reply, static_cast<int32_t>(bits.size()));
+        for (int32_t w : bits) push_int(reply, w);
+        return JNI_TRUE;
+    }
+    sleep_us(g_config.daemon_call_us);
+    return JNI_FALSE;
+}
+
+Obj* sm_get_service(const std::string& name) {
+    g_stats.sm_calls.fetch_add(1, std::memory_order_relaxed);
+    sleep_us(g_config.sm_call_us);
+    if (name == kMurasakiService) {
+        Obj* daemon = g_daemon_binder.load();
+        return g_config.daemon_ready && daemon->alive.load() ? daemon : nullptr;
+    }
+    if (name == kShizukuService) return g_shizuku_binder;
+    return nullptr;
+}
+
+jvalue invoke(Obj* self, jmethodID mid, va_list args) {
+    jvalue r;
+    r.j = 0;
+    auto m = static_cast<M>(reinterpret_cast<uintptr_t>(mid) - 1);
+    switch (m) {
+        case M::Binder_getCallingUid:
+            r.i = t_uid;
+            break;
+        case M::Binder_getCallingPid:
+            r.i = t_pid;
+            break;
+        case M::Parcel_obtainPtr:
+            r.l = J(reinterpret_cast<Obj*>(static_cast<uintptr_t>(va_arg(args, jlong))));
+            break;
+        case M::Parcel_obtain:
+            r.l = J(local(Kind::Parcel));
+            break;
+        case M::Parcel_recycle:
+            break;
+        case M::Parcel_setDataPosition:
+            (void) va_arg(args, jint);
+            self->pos = 0;
+            break;
+        case M::Parcel_enforceInterface: {
+            Obj* desc = O(va_arg(args, jobject));
+            ParcelEntry* e = next_entry(self, ParcelEntry::Str);
+            if (!e || !desc || e->s != desc->str) t_pending = true;  // SecurityException
+            break;
+        }
+        case M::Parcel_readInt:
+        case M::Parcel_readByte: {
+            ParcelEntry* e = next_entry(self, ParcelEntry::Int);
+            if (m == M::Parcel_readInt)
+                r.i = e ? e->i : 0;
+            else
+                r.b = e ? static_cast<jbyte>(e->i) : 0;
+            break;
+        }
+        case M::Parcel_readString: {
+            ParcelEntry* e = next_entry(self, ParcelEntry::Str);
+            r.l = e ? J(local_string(e->s)) : nullptr;
+            break;
+        }
+        case M::Parcel_writeInterfaceToken:
+            push_str(self, O(va_arg(args, jobject))->str);
+            break;
+        case M::Parcel_writeInt:
+            push_int(self, va_arg(args, jint));
+            break;
+        case M::Parcel_writeNoException:
+            push_int(self, 0);
+            break;
+        case M::Parcel_writeStrongBinder: {
+            ParcelEntry e;
+            e.type = ParcelEntry::Binder;
+            e.binder = O(va_arg(args, jobject));
+            self->parcel.push_back(std::move(e));
+            break;
+        }
+        case M::Parcel_readException: {
+            ParcelEntry* e = next_entry(self, ParcelEntry::Int);
+            if (!e || e->i != 0) t_pending = true;
+            break;
+        }
+        case M::Parcel_dataAvail:
+            // Entries stand in for 4-byte words; only "anything left" matters to the bridge
+            r.i = static_cast<jint>((self->parcel.size() - self->pos) * 4);
+            break;
+        case M::Parcel_writeIntArray: {
+            // Same layout as the real Parcel: length, then the elements
+            Obj* arr = O(va_arg(args, jobject));
+            push_int(self, arr ? static_cast<int32_t>(arr->ints.size()) : -1);
+            if (arr) {
+                for (int32_t v : arr->ints) push_int(self, v);
+            }
+            break;
+        }
+        case M::Parcel_createIntArray: {
+            ParcelEntry* n = next_entry(self, ParcelEntry::Int);
+            if (!n || n->i < 0) break;
+            Obj* arr = local(Kind::IntArray);
+            for (int32_t i = 0; i < n->i; ++i) {
+                ParcelEntry* e = next_entry(self, ParcelEntry::Int);
+                arr->ints.push_back(e ? e->i : 0);
+            }
+            r.l = J(arr);
+            break;
+        }
+        case M::SM_getService:
+            r.l = J(sm_get_service(O(va_arg(args, jobject))->str));
+            break;
+        case M::IBinder_transact: {
+            jint code = va_arg(args, jint);
+            Obj* data = O(va_arg(args, jobject));
+            Obj* reply = O(va_arg(args, jobject));
+            r.z = binder_transact(self, code, data, reply);
+            break;
+        }
+        case M::IBinder_pingBinder:
+            if (self == g_daemon_binder) {
+                g_stats.daemon_calls.fetch_add(1, std::memory_order_relaxed);
+                sleep_us(g_config.daemon_call_us);
+            }
+            r.z = check_alive(self) ? JNI_TRUE : JNI_FALSE;
+            break;
+        case M::IBinder_isBinderAlive:
+            r.z = self->obituary.load() ? JNI_FALSE : JNI_TRUE;
+            break;
+        case M::AT_currentActivityThread:
+            r.l = J(g_activity_thread);
+            break;
+        case M::AT_getSystemContext:
+            r.l = J(g_context);
+            break;
+        case M::Context_getPackageManager:
+            r.l = J(g_pm);
+            break;
+        case M::Context_startActivity:
+            g_stats.auth_dialogs.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case M::PM_getPackagesForUid: {
+            jint uid = va_arg(args, jint);
+            g_stats.pm_calls.fetch_add(1, std::memory_order_relaxed);
+            sleep_us(g_config.pm_call_us);
+            Obj* arr = local(Kind::Array);
+            arr->elems.push_back(local_string("com.example.app" + std::to_string(uid)));
+            r.l = J(arr);
+            break;
+        }
+        case M::PM_getPackageInfo:
+        case M::PM_getApplicationInfo: {
+            Obj* pkg = O(va_arg(args, jobject));
+            (void) va_arg(args, jint);
+            g_stats.pm_calls.fetch_add(1, std::memory_order_relaxed);
+            sleep_us(g_config.pm_call_us);
+            int uid = atoi(pkg->str.c_str() + strlen("com.example.app"));
+            Obj* info = local(m == M::PM_getPackageInfo ? Kind::PackageInfo : Kind::AppInfo);
+            info->uid = uid;
+            if (m == M::PM_getPackageInfo) {
+                info->elems.push_back(local_string("android.permission.INTERNET"));
+                if (declared(uid)) info->elems.push_back(local_string(kShizukuPermission));
+            }
+            r.l = J(info);
+            break;
+        }
+        case M::Bundle_getBoolean:
+            (void) va_arg(args, jobject);
+            r.z = static_cast<jboolean>(va_arg(args, int));
+            break;
+        case M::String_startsWith: {
+            Obj* prefix = O(va_arg(args, jobject));
+            r.z = self->str.compare(0, prefix->str.size(), prefix->str) == 0;
+            break;
+        }
+        case M::Intent_init:
+            break;
+        case M::Intent_setClassName:
+        case M::Intent_putExtra_SS:
+        case M::Intent_putExtra_SI:
+        case M::Intent_addFlags:
+            r.l = J(self);
+            break;
+        case M::Count:
+            t_pending = true;
+            break;
+    }
+    return r;
+}
+
+jmethodID find_method(jclass cls, const char* name, const char* sig) {
+    Obj* c = O(cls);
+    for (size_t i = 0; i < static_cast<size_t>(M::Count); ++i) {
+        const MethodDesc& d = kMethods[i];
+        if (c && c->str == d.cls && strcmp(d.name, name) == 0 && strcmp(d.sig, sig) == 0) {
+            return reinterpret_cast<jmethodID>(i + 1);
+        }
+    }
+    t_pending = true;  // NoSuchMethodError
+    return nullptr;
+}
+
+jfieldID find_field(jclass cls, const char* name) {
+    Obj* c = O(cls);
+    F f;
+    if (strcmp(name, "GET_PERMISSIONS") == 0)
+        f = F::PM_GET_PERMISSIONS;
+    else if (strcmp(name, "GET_META_DATA") == 0)
+        f = F::PM_GET_META_DATA;
+    else if (strcmp(name, "requestedPermissions") == 0)
+        f = F::PackageInfo_requestedPermissions;
+    else if (strcmp(name, "metaData") == 0)
+        f = F::ApplicationInfo_metaData;
+    else {
+        t_pending = true;  // NoSuchFieldError
+        return nullptr;
+    }
+    (void) c;
+    return reinterpret_cast<jfieldID>(static_cast<uintptr_t>(f));
+}
+
+void init_vm_table() {
+    InvokeInterface& t = g_vm_table;
+    // The env out-parameter is JNIEnv** in Android's jni.h and void** in the JDK's
+    t.AttachCurrentThread = [](JavaVM*, auto penv, void*) -> jint {
+        *reinterpret_cast<JNIEnv**>(penv) = threadEnv();
+        return JNI_OK;
+    };
+    t.AttachCurrentThreadAsDaemon = [](JavaVM*, auto penv, void*) -> jint {
+        *reinterpret_cast<JNIEnv**>(penv) = threadEnv();
+        return JNI_OK;
+    };
+    t.DetachCurrentThread = [](JavaVM*) -> jint { return JNI_OK; };
+    t.GetEnv = [](JavaVM*, void** penv, jint) -> jint {
+        *penv = threadEnv();
+        return JNI_OK;
+    };
+    g_vm.functions = &g_vm_table;
+}
+
+void init_table() {
+    NativeInterface& t = g_table;
+    t.FindClass = [](JNIEnv*, const char* name) -> jclass {
+        auto it = g_classes.find(name);
+        if (it == g_classes.end()) {
+            t_pending = true;
+            return nullptr;
+        }
+        return reinterpret_cast<jclass>(it->second);
+    };
+    t.ExceptionOccurred = [](JNIEnv*) -> jthrowable { return nullptr; };
+    t.ExceptionClear = [](JNIEnv*) { t_pending = false; };
+    t.ExceptionCheck = [](JNIEnv*) -> jboolean { return t_pending ? JNI_TRUE : JNI_FALSE; };
+    t.NewGlobalRef = [](JNIEnv*, jobject o) -> jobject {
+        Obj* obj = O(o);
+        if (obj && !obj->pinned) {
+            obj->pinned = true;
+            for (Obj*& a : t_arena) {
+                if (a == obj) a = nullptr;
+            }
+        }
+        return o;
+    };
+    t.DeleteGlobalRef = [](JNIEnv*, jobject o) {
+        Obj* obj = O(o);
+        if (obj && !obj->permanent) delete obj;
+    };
+    t.DeleteLocalRef = [](JNIEnv*, jobject) {};
+    // One frame deep: popping releases everything created on the thread (see endFrame)
+    t.PushLocalFrame = [](JNIEnv*, jint) -> jint { return JNI_OK; };
+    t.PopLocalFrame = [](JNIEnv*, jobject result) -> jobject {
+        endFrame();
+        return result;
+    };
+    t.GetJavaVM = [](JNIEnv*, JavaVM** vm) -> jint {
+        *vm = &g_vm;
+        return JNI_OK;
+    };
+    t.NewLocalRef = [](JNIEnv*, jobject o) -> jobject { return o; };
+    t.IsSameObject = [](JNIEnv*, jobject a, jobject b) -> jboolean { return a == b ? JNI_TRUE : JNI_FALSE; };
+    t.NewObjectV = [](JNIEnv*, jclass, jmethodID, va_list) -> jobject { return J(local(Kind::Intent)); };
+    t.GetMethodID = [](JNIEnv*, jclass c, const char* n, const char* s) { return find_method(c, n, s); };
+    t.GetStaticMethodID = [](JNIEnv*, jclass c, const char* n, const char* s) { return find_method(c, n, s); };
+    t.GetFieldID = [](JNIEnv*, jclass c, const char* n, const char*) { return find_field(c, n); };
+    t.GetStaticFieldID = [](JNIEnv*, jclass c, const char* n, const char*) { return find_field(c, n); };
+
+    t.CallObjectMethodV = [](JNIEnv*, jobject o, jmethodID m, va_list a) { return invoke(O(o), m, a).l; };
+    t.CallBooleanMethodV = [](JNIEnv*, jobject o, jmethodID m, va_list a) { return invoke(O(o), m, a).z; };
+    t.CallByteMethodV = [](JNIEnv*, jobject o, jmethodID m, va_list a) { return invoke(O(o), m, a).b; };
+    t.CallIntMethodV = [](JNIEnv*, jobject o, jmethodID m, va_list a) { return invoke(O(o), m, a).i; };
+    t.CallLongMethodV = [](JNIEnv*, jobject o, jmethodID m, va_list a) { return invoke(O(o), m, a).j; };
+    t.CallVoidMethodV = [](JNIEnv*, jobject o, jmethodID m, va_list a) { (void) invoke(O(o), m, a); };
+    t.CallStaticObjectMethodV = [](JNIEnv*, jclass, jmethodID m, va_list a) { return invoke(nullptr, m, a).l; };
+    t.CallStaticBooleanMethodV = [](JNIEnv*, jclass, jmethodID m, va_list a) { return invoke(nullptr, m, a).z; };
+    t.CallStaticIntMethodV = [](JNIEnv*, jclass, jmethodID m, va_list a) { return invoke(nullptr, m, a).i; };
+    t.CallStaticLongMethodV = [](JNIEnv*, jclass, jmethodID m, va_list a) { return invoke(nullptr, m, a).j; };
+    t.CallStaticVoidMethodV = [](JNIEnv*, jclass, jmethodID m, va_list a) { (void) invoke(nullptr, m, a); };
+
+    t.GetObjectField = [](JNIEnv*, jobject o, jfieldID f) -> jobject {
+        Obj* obj = O(o);
+        switch (static_cast<F>(reinterpret_cast<uintptr_t>(f))) {
+            case F::PackageInfo_requestedPermissions: {
+                Obj* arr = local(Kind::Array);
+                arr->elems = obj->elems;
+                return J(arr);
+            }
+            case F::ApplicationInfo_metaData:
+                return J(local(Kind::Bundle));
+            default:
+                return nullptr;
+        }
+    };
+    t.GetStaticIntField = [](JNIEnv*, jclass, jfieldID f) -> jint {
+        switch (static_cast<F>(reinterpret_cast<uintptr_t>(f))) {
+            case F::PM_GET_PERMISSIONS:
+                return kGetPermissions;
+            case F::PM_GET_META_DATA:
+                return kGetMetaData;
+            default:
+                return 0;
+        }
+    };
+    t.NewStringUTF = [](JNIEnv*, const char* s) -> jstring {
+        return reinterpret_cast<jstring>(local_string(s ? s : ""));
+    };
+    t.GetStringUTFChars = [](JNIEnv*, jstring s, jboolean* is_copy) -> const char* {
+        if (is_copy) *is_copy = JNI_FALSE;
+        return O(s)->str.c_str();
+    };
+    t.ReleaseStringUTFChars = [](JNIEnv*, jstring, const char*) {};
+    t.GetArrayLength = [](JNIEnv*, jarray a) -> jsize {
+        Obj* arr = O(a);
+        return static_cast<jsize>(arr->kind == Kind::IntArray ? arr->ints.size() : arr->elems.size());
+    };
+    t.NewIntArray = [](JNIEnv*, jsize n) -> jintArray {
+        Obj* arr = local(Kind::IntArray);
+        arr->ints.resize(static_cast<size_t>(n));
+        return reinterpret_cast<jintArray>(arr);
+    };
+    t.SetIntArrayRegion = [](JNIEnv*, jintArray a, jsize start, jsize n, const jint* buf) {
+        std::copy(buf, buf + n, O(a)->ints.begin() + start);
+    };
+    t.GetIntArrayRegion = [](JNIEnv*, jintArray a, jsize start, jsize n, jint* buf) {
+        const std::vector<int32_t>& v = O(a)->ints;
+        std::copy(v.begin() + start, v.begin() + start + n, buf);
+    };
+    t.GetObjectArrayElement = [](JNIEnv*, jobjectArray a, jsize i) -> jobject {
+        Obj* arr = O(a);
+        return i >= 0 && static_cast<size_t>(i) < arr->elems.size() ? J(arr->elems[i]) : nullptr;
+    };
+}
+
+}  // namespace
+
+void initWorld(const WorldConfig& config) {
+    g_config = config;
+    if (!g_classes.empty()) return;
+    init_table();
+    init_vm_table();
+    for (const char* name : kClassNames) {
+        g_classes[name] = permanent(Kind::Class, name);
+    }
+    g_activity_thread = permanent(Kind::ActivityThread);
+    g_context = permanent(Kind::Context);
+    g_pm = permanent(Kind::PackageManager);
+    g_daemon_binder = permanent(Kind::Binder, kMurasakiService);
+    g_shizuku_binder = permanent(Kind::Binder, kShizukuService);
+    g_stub_binder = permanent(Kind::Binder, "stub");
+}
+
+WorldConfig& world() {
+    return g_config;
+}
+
+WorldStats& worldStats() {
+    return g_stats;
+}
+
+JNIEnv* threadEnv() {
+    thread_local JNIEnv env = [] {
+        JNIEnv e;
+        e.functions = &g_table;
+        return e;
+    }();
+    return &env;
+}
+
+JavaVM* javaVm() {
+    return &g_vm;
+}
+
+void setDaemonRunning(bool running) {
+    if (running) {
+        g_daemon_binder.store(permanent(Kind::Binder, kMurasakiService));  // old proxies stay dead
+    } else {
+        g_daemon_binder.load()->alive.store(false);
+    }
+    g_config.daemon_ready = running;
+}
+
+void setCallingIdentity(int uid, int pid) {
+    t_uid = uid;
+    t_pid = pid;
+}
+
+Transaction makeMrskTransaction(jint action, jint version) {
+    Obj* data = local(Kind::Parcel);
+    push_str(data, kAmsDescriptor);
+    push_int(data, action);
+    if (version > 1) push_int(data, version);
+    Obj* reply = local(Kind::Parcel);
+    return {static_cast<jlong>(reinterpret_cast<uintptr_t>(data)),
+            static_cast<jlong>(reinterpret_cast<uintptr_t>(reply))};
+}
+
+Transaction makeOtherTransaction() {
+    Obj* data = local(Kind::Parcel);
+    push_str(data, kAmsDescriptor);
+    Obj* reply = local(Kind::Parcel);
+    return {static_cast<jlong>(reinterpret_cast<uintptr_t>(data)),
+            static_cast<jlong>(reinterpret_cast<uintptr_t>(reply))};
+}
+
+jobject replyBinder(const Transaction& tx) {
+    Obj* reply = reinterpret_cast<Obj*>(static_cast<uintptr_t>(tx.reply));
+    for (const ParcelEntry& e : reply->parcel) {
+        if (e.type == ParcelEntry::Binder) return J(e.binder);
+    }
+    return nullptr;
+}
+
+bool replyStatus(const Transaction& tx, jint* status, jint* retry_after_ms) {
+    Obj* reply = reinterpret_cast<Obj*>(static_cast<uintptr_t>(tx.reply));
+    // noException, version, status, retry-after, binder
+    const std::vector<ParcelEntry>& p = reply->parcel;
+    if (p.size() < 4 || p[0].type != ParcelEntry::Int || p[1].type != ParcelEntry::Int || p[1].i < 2) {
+        return false;
+    }
+    *status = p[2].i;
+    *retry_after_ms = p[3].i;
+    return true;
+}
+
+void endFrame() {
+    for (Obj* o : t_arena) {
+        if (o && !o->pinned) delete o;
+    }
+    t_arena.clear();
+    t_pending = false;
+}
+
+jboolean origExecTransact(JNIEnv*, jobject, jint, jlong, jlong, jint) {
+    g_stats.orig_exec_transact.fetch_add(1, std::memory_order_relaxed);
+    return JNI_TRUE;
+}
+
+jobject fakeBinderStub() {
+    return J(g_stub_binder);
+}
+
+}  // namespace murasaki::bench
+
+namespace murasaki::bridge {
+
+// Start-time source of src/session_cache.cpp on host builds.
+uint64_t hostProcessStartTime(int pid) {
+    const bench::WorldConfig& cfg = bench::world();
+    return cfg.process_start_time ? cfg.process_start_time(pid) : 1;
+}
+
+}  // namespace murasaki::bridge
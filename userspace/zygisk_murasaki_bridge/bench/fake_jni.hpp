@@ -0,0 +1,85 @@
+#pragma once
+
+// Stand-in JNIEnv for host benchmarks: a JNI function table that models just the framework classes
+// the bridge touches (Binder, Parcel, ServiceManager, PackageManager, ...) with configurable latency.
+// Objects created during a transaction live until endFrame(), mirroring a JNI local frame.
+
+#include <jni.h>
+
+#include <atomic>
+#include <cstdint>
+
+namespace murasaki::bench {
+
+struct WorldConfig {
+    uint32_t pm_call_us = 40;      // each PackageManager round trip
+    uint32_t sm_call_us = 15;      // ServiceManager.getService
+    uint32_t daemon_call_us = 30;  // IMurasakiService transact / ping
+    bool daemon_ready = true;
+    // uid -> declared in manifest / granted by daemon. Defaults: everything declared and granted.
+    bool (*is_declared)(int uid) = nullptr;
+    bool (*is_granted)(int uid) = nullptr;
+    // Extra latency of daemon grant queries about uid (slow daemon responses). Keyed by uid rather
+    // than by calling thread because the bridge may issue the query from a helper thread.
+    uint32_t (*daemon_extra_us)(int uid) = nullptr;
+    // /proc/<pid>/stat start time seen by the session cache (0 = process gone). Default: every pid
+    // is alive and started at tick 1, so results do not depend on the host's real processes.
+    uint64_t (*process_start_time)(int pid) = nullptr;
+    // Daemon reports interface version 2 and implements the bulk getUidsGrantedRoot call; otherwise
+    // it rejects both codes. Change it only while the daemon is stopped (setDaemonRunning): the bridge
+    // remembers the answer per daemon binder.
+    bool daemon_bulk_query = true;
+};
+
+struct WorldStats {
+    std::atomic<uint64_t> pm_calls{0};
+    std::atomic<uint64_t> sm_calls{0};
+    std::atomic<uint64_t> daemon_calls{0};
+    std::atomic<uint64_t> auth_dialogs{0};
+    std::atomic<uint64_t> orig_exec_transact{0};
+};
+
+void initWorld(const WorldConfig& config);
+WorldConfig& world();
+WorldStats& worldStats();
+
+// Per-thread JNIEnv backed by the fake function table.
+JNIEnv* threadEnv();
+
+// JavaVM whose AttachCurrentThread* hand out threadEnv(); also returned by JNIEnv::GetJavaVM.
+JavaVM* javaVm();
+
+// Daemon crash (false): its binder dies and ServiceManager stops returning it. Restart (true)
+// registers a new binder. Proxies only notice a death when a call on them fails.
+void setDaemonRunning(bool running);
+
+// Binder.getCallingUid()/getCallingPid() for the current thread.
+void setCallingIdentity(int uid, int pid);
+
+// Native Parcel pointers as handed to Binder#execTransact(IJJI)Z.
+struct Transaction {
+    jlong data;
+    jlong reply;
+};
+
+// MRSK request: AMS interface token followed by the action, and the protocol version for v2+.
+Transaction makeMrskTransaction(jint action, jint version = 1);
+// Any other ActivityManager/Binder transaction.
+Transaction makeOtherTransaction();
+
+// Binder written to the reply by the bridge, or nullptr.
+jobject replyBinder(const Transaction& tx);
+
+// Status and retry-after hint of a v2 reply; false for a v1 or empty reply.
+bool replyStatus(const Transaction& tx, jint* status, jint* retry_after_ms);
+
+// Frees every object created on this thread since the last call (JNI local frame pop).
+void endFrame();
+
+// Original Binder#execTransact stand-in: counts the call and reports it as handled.
+jboolean origExecTransact(JNIEnv* env, jobject thiz, jint code, jlong data, jlong reply, jint flags);
+
+// Any Binder object, used as the `thiz` argument.
+jobject fakeBinderStub();
+
+}  // namespace murasaki::bench
@@ -0,0 +1,106 @@
+// Re-checking the daemon grant of many uids (what the bridge does for its cached sessions after a
+// daemon restart): one bulk getUidsGrantedRoot transaction versus one isUidGrantedRoot per uid.
+//
+//   grant_refresh_bench [iters=20] [daemon_us=30]
+//
+// Each mode runs against a freshly started daemon; the bridge asks its interface version once,
+// outside the timed calls.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/bridge.hpp"
+#include "fake_jni.hpp"
+
+using namespace murasaki;
+
+namespace {
+
+constexpr jint kUidBase = 10000;
+constexpr size_t kUidCounts[] = {1, 8, 32, 128, 512, 1024};
+
+struct Options {
+    long iters = 20;
+    uint32_t daemon_us = 30;
+};
+
+bool is_granted(int uid) {
+    return uid % 3 != 0;
+}
+
+struct Result {
+    double us = 0;  // per refresh, best of iters
+    double daemon_calls = 0;
+    bool correct = true;
+};
+
+Result run(JNIEnv* env, const std::vector<jint>& uids, bool bulk, long iters) {
+    bench::setDaemonRunning(false);
+    bench::world().daemon_bulk_query = bulk;
+    bench::setDaemonRunning(true);
+    std::unique_ptr<bool[]> granted(new bool[uids.size()]);
+    // The first call finds the previous daemon's binder dead, the second asks the new one's version
+    for (int warmup = 0; warmup < 2; ++warmup) {
+        bridge::queryDaemonGrants(env, uids.data(), uids.size(), granted.get());
+        bench::endFrame();
+    }
+    Result r;
+    uint64_t calls0 = bench::worldStats().daemon_calls.load();
+    for (long i = 0; i < iters; ++i) {
+        bool* out = granted.get();
+        auto t0 = std::chrono::steady_clock::now();
+        bool ok = bridge::queryDaemonGrants(env, uids.data(), uids.size(), out);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+        if (i == 0 || us < r.us) r.us = us;
+        for (size_t k = 0; k < uids.size(); ++k) {
+            if (!ok || out[k] != is_granted(uids[k])) r.correct = false;
+        }
+        bench::endFrame();
+    }
+    r.daemon_calls = static_cast<double>(bench::worldStats().daemon_calls.load() - calls0) / static_cast<double>(iters);
+    return r;
+}
+
+void parse(Options& opt, int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char* eq = strchr(argv[i], '=');
+        if (!eq) continue;
+        std::string key(argv[i], eq - argv[i]);
+        long v = atol(eq + 1);
+        if (key == "iters") opt.iters = v;
+        else if (key == "daemon_us") opt.daemon_us = static_cast<uint32_t>(v);
+        else fprintf(stderr, "unknown option %s\n", key.c_str());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    parse(opt, argc, argv);
+
+    bench::WorldConfig cfg;
+    cfg.is_granted = is_granted;
+    cfg.daemon_call_us = opt.daemon_us;
+    bench::initWorld(cfg);
+
+    JNIEnv* env = bench::threadEnv();
+    printf("iters=%ld daemon=%uus per transact\n\n", opt.iters, opt.daemon_us);
+    printf("%6s %13s %13s %13s %13s %8s\n", "uids", "per-uid(us)", "bulk(us)", "per-uid ipc", "bulk ipc", "speedup");
+
+    for (size_t n : kUidCounts) {
+        std::vector<jint> uids(n);
+        for (size_t i = 0; i < n; ++i) uids[i] = kUidBase + static_cast<jint>(i);
+        Result loop = run(env, uids, false, opt.iters);
+        Result bulk = run(env, uids, true, opt.iters);
+        printf("%6zu %13.1f %13.1f %13.1f %13.1f %7.1fx%s\n", n, loop.us, bulk.us, loop.daemon_calls,
+               bulk.daemon_calls, bulk.us > 0 ? loop.us / bulk.us : 0,
+               loop.correct && bulk.correct ? "" : "  MISMATCH");
+    }
+    return 0;
+}
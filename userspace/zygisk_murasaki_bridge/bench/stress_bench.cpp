@@ -0,0 +1,193 @@
+// Boot-storm stress: N binder threads drive bridge::execTransact with a mix of MRSK actions, denied
+// callers, slow daemon replies and ordinary traffic, and report throughput and tail latency per N.
+//
+//   stress_bench [requests=2000] [mrsk=50] [denied=20] [slow=10] [slow_us=2000] [max_threads=64]
+//
+// mrsk/denied/slow are percentages: share of MRSK among all transactions, share of denied callers
+// (half undeclared, half not granted by the daemon) among MRSK, share of uids the daemon is slow for.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/bridge.hpp"
+#include "fake_jni.hpp"
+
+using namespace murasaki;
+
+namespace {
+
+constexpr jint kMrsk = ('M' << 24) | ('R' << 16) | ('S' << 8) | 'K';
+constexpr jint kActionShizuku = 1;
+constexpr jint kActionMurasaki = 2;
+
+// uid ranges understood by the stand-in PackageManager and daemon
+constexpr int kGrantedUidBase = 10000;
+constexpr int kUndeclaredUidBase = 20000;
+constexpr int kUngrantedUidBase = 30000;
+constexpr int kUidsPerRange = 2048;
+
+struct Options {
+    long requests = 2000;  // per thread
+    int mrsk_pct = 50;
+    int denied_pct = 20;
+    int slow_pct = 10;
+    uint32_t slow_us = 2000;
+    int max_threads = 64;
+};
+
+struct ThreadResult {
+    std::vector<uint32_t> mrsk_ns;
+    std::vector<uint32_t> other_ns;
+    long granted = 0;
+    long denied = 0;
+};
+
+struct XorShift {
+    uint64_t s;
+    uint32_t next() {
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return static_cast<uint32_t>(s);
+    }
+    bool pct(int p) { return static_cast<int>(next() % 100) < p; }
+};
+
+bool is_declared(int uid) {
+    return uid < kUndeclaredUidBase || uid >= kUngrantedUidBase;
+}
+
+bool is_granted(int uid) {
+    return uid < kUndeclaredUidBase;
+}
+
+int g_slow_pct = 0;
+uint32_t g_slow_us = 0;
+
+uint32_t daemon_extra_us(int uid) {
+    return (static_cast<uint32_t>(uid) * 2654435761u >> 16) % 100 < static_cast<uint32_t>(g_slow_pct) ? g_slow_us : 0;
+}
+
+void run_thread(const Options& opt, int tid, ThreadResult* out) {
+    JNIEnv* env = bench::threadEnv();
+    jobject thiz = bench::fakeBinderStub();
+    XorShift rng{0x9E3779B97F4A7C15ull ^ (static_cast<uint64_t>(tid + 1) << 32)};
+    out->mrsk_ns.reserve(opt.requests);
+
+    for (long i = 0; i < opt.requests; ++i) {
+        bool mrsk = rng.pct(opt.mrsk_pct);
+        bench::Transaction tx;
+        jint code = kMrsk;
+        if (mrsk) {
+            int uid = kGrantedUidBase;
+            if (rng.pct(opt.denied_pct)) {
+                uid = (rng.next() & 1) ? kUndeclaredUidBase : kUngrantedUidBase;
+            }
+            uid += static_cast<int>(rng.next() % kUidsPerRange);
+            bench::setCallingIdentity(uid, 2000 + uid);
+            tx = bench::makeMrskTransaction((rng.next() & 1) ? kActionMurasaki : kActionShizuku);
+        } else {
+            code = 1;
+            tx = bench::makeOtherTransaction();
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        jboolean handled = bridge::execTransact(env, thiz, code, tx.data, tx.reply, 0);
+        auto t1 = std::chrono::steady_clock::now();
+        auto ns = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+
+        if (mrsk) {
+            out->mrsk_ns.push_back(ns);
+            if (handled && bench::replyBinder(tx))
+                ++out->granted;
+            else
+                ++out->denied;
+        } else {
+            out->other_ns.push_back(ns);
+        }
+        bench::endFrame();
+    }
+}
+
+double percentile_us(std::vector<uint32_t>& v, double p) {
+    if (v.empty()) return 0;
+    size_t k = std::min(v.size() - 1, static_cast<size_t>(p * static_cast<double>(v.size())));
+    std::nth_element(v.begin(), v.begin() + static_cast<long>(k), v.end());
+    return v[k] / 1000.0;
+}
+
+void parse(Options& opt, int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const char* eq = strchr(argv[i], '=');
+        if (!eq) continue;
+        std::string key(argv[i], eq - argv[i]);
+        long v = atol(eq + 1);
+        if (key == "requests") opt.requests = v;
+        else if (key == "mrsk") opt.mrsk_pct = static_cast<int>(v);
+        else if (key == "denied") opt.denied_pct = static_cast<int>(v);
+        else if (key == "slow") opt.slow_pct = static_cast<int>(v);
+        else if (key == "slow_us") opt.slow_us = static_cast<uint32_t>(v);
+        else if (key == "max_threads") opt.max_threads = static_cast<int>(v);
+        else fprintf(stderr, "unknown option %s\n", key.c_str());
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    parse(opt, argc, argv);
+
+    bench::WorldConfig cfg;
+    cfg.is_declared = is_declared;
+    cfg.is_granted = is_granted;
+    cfg.daemon_extra_us = daemon_extra_us;
+    g_slow_pct = opt.slow_pct;
+    g_slow_us = opt.slow_us;
+    bench::initWorld(cfg);
+    bridge::setOriginalExecTransact(bench::origExecTransact);
+
+    printf("requests/thread=%ld mrsk=%d%% denied=%d%% slow=%d%% (+%uus) pm=%uus sm=%uus daemon=%uus\n\n",
+           opt.requests, opt.mrsk_pct, opt.denied_pct, opt.slow_pct, opt.slow_us, cfg.pm_call_us, cfg.sm_call_us,
+           cfg.daemon_call_us);
+    printf("%7s %11s %9s %9s %9s %9s %9s %9s %9s\n", "threads", "tx/s", "mrsk/s", "p50(us)", "p99(us)",
+           "p999(us)", "max(us)", "other p99", "granted%");
+
+    for (int n = 1; n <= opt.max_threads; n *= 2) {
+        std::vector<ThreadResult> results(n);
+        std::vector<std::thread> threads;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int t = 0; t < n; ++t) {
+            threads.emplace_back(run_thread, std::cref(opt), t, &results[t]);
+        }
+        for (auto& th : threads) th.join();
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::vector<uint32_t> mrsk, other;
+        long granted = 0, denied = 0;
+        for (auto& r : results) {
+            mrsk.insert(mrsk.end(), r.mrsk_ns.begin(), r.mrsk_ns.end());
+            other.insert(other.end(), r.other_ns.begin(), r.other_ns.end());
+            granted += r.granted;
+            denied += r.denied;
+        }
+        double total = static_cast<double>(mrsk.size() + other.size());
+        double max_us = mrsk.empty() ? 0 : *std::max_element(mrsk.begin(), mrsk.end()) / 1000.0;
+        printf("%7d %11.0f %9.0f %9.1f %9.1f %9.1f %9.1f %9.2f %8.1f%%\n", n, total / secs,
+               static_cast<double>(mrsk.size()) / secs, percentile_us(mrsk, 0.50), percentile_us(mrsk, 0.99),
+               percentile_us(mrsk, 0.999), max_us, percentile_us(other, 0.99),
+               granted + denied ? 100.0 * static_cast<double>(granted) / static_cast<double>(granted + denied) : 0);
+    }
+
+    bench::WorldStats& st = bench::worldStats();
+    printf("\nframework calls: pm=%llu sm=%llu daemon=%llu dialogs=%llu\n",
+           (unsigned long long) st.pm_calls.load(), (unsigned long long) st.sm_calls.load(),
+           (unsigned long long) st.daemon_calls.load(), (unsigned long long) st.auth_dialogs.load());
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include "audit_log.hpp"
+
+#include <time.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace murasaki::bridge {
+
+static constexpr const char* kVerdictNames[] = {
+    "granted",
+    "granted-session",
+    "denied-ratelimit",
+    "denied-allowlist",
+    "denied-daemon",
+    "denied-declared",
+    "service-missing",
+};
+static_assert(sizeof(kVerdictNames) / sizeof(kVerdictNames[0]) == static_cast<size_t>(AuditVerdict::Count),
+              "verdict names out of sync");
+
+int64_t realtimeMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
+const char* auditVerdictName(AuditVerdict verdict) {
+    size_t i = static_cast<size_t>(verdict);
+    return i < static_cast<size_t>(AuditVerdict::Count) ? kVerdictNames[i] : "?";
+}
+
+size_t formatAuditLine(const AuditRecord& r, const char* package, char* buf, size_t size) {
+    int n = snprintf(buf, size, "%" PRId64 "\t%d\t%d\t%d\t%s\t%u\t%s\n", r.time_ms, r.uid, r.pid, r.action,
+                     auditVerdictName(r.verdict), r.latency_us, package && *package ? package : "-");
+    if (n < 0) return 0;
+    return static_cast<size_t>(n) < size ? static_cast<size_t>(n) : size - 1;
+}
+
+bool parseAuditLine(const char* line, AuditRecord* r, char* package, size_t package_size) {
+    char verdict[32];
+    char pkg[256];
+    int64_t time_ms = 0;
+    int uid = 0, pid = 0, action = 0;
+    unsigned latency = 0;
+    if (sscanf(line, "%" SCNd64 "\t%d\t%d\t%d\t%31s\t%u\t%255s", &time_ms, &uid, &pid, &action, verdict, &latency,
+               pkg) != 7) {
+        return false;
+    }
+    size_t v = 0;
+    while (v < static_cast<size_t>(AuditVerdict::Count) && strcmp(kVerdictNames[v], verdict) != 0) ++v;
+    if (v == static_cast<size_t>(AuditVerdict::Count)) return false;
+
+    r->time_ms = time_ms;
+    r->uid = uid;
+    r->pid = pid;
+    r->action = action;
+    r->latency_us = latency;
+    r->verdict = static_cast<AuditVerdict>(v);
+    if (package && package_size) {
+        snprintf(package, package_size, "%s", pkg);
+    }
+    return true;
+}
+
+}  // namespace murasaki::bridge
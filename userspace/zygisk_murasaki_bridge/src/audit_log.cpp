@@ -0,0 +1,193 @@
+#include "audit_log.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "log.hpp"
+
+namespace murasaki::bridge {
+
+static constexpr size_t kQueueCapacity = 1024;  // power of two
+static constexpr useconds_t kFlushIntervalUs = 250000;  // 250ms group commit
+static constexpr off_t kMaxLogBytes = 256 * 1024;  // rotate to audit.log.1 beyond this
+static constexpr const char* PACKAGES_LIST = "/data/system/packages.list";
+
+static_assert((kQueueCapacity & (kQueueCapacity - 1)) == 0, "queue capacity must be a power of two");
+
+// Bounded MPSC ring (Vyukov): each cell carries a sequence number, producers claim a slot with one
+// CAS on the tail, the single writer thread consumes in order.
+struct Cell {
+    std::atomic<size_t> seq;
+    AuditRecord record;
+};
+
+static Cell g_cells[kQueueCapacity];
+static std::atomic<size_t> g_tail{0};
+static size_t g_head = 0;  // writer thread only
+static std::atomic<uint64_t> g_dropped{0};
+static std::once_flag g_writer_once;
+
+static void writer_main();
+
+static void init_queue() {
+    for (size_t i = 0; i < kQueueCapacity; ++i) {
+        g_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+    std::thread(writer_main).detach();
+}
+
+void auditLogSubmit(const AuditRecord& record) {
+    std::call_once(g_writer_once, init_queue);
+    size_t pos = g_tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = g_cells[pos & (kQueueCapacity - 1)];
+        size_t seq = cell.seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (g_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.record = record;
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return;
+            }
+        } else if (diff < 0) {
+            // 队列已满：丢弃而不阻塞 binder 线程
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = g_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+static bool pop(AuditRecord* out) {
+    Cell& cell = g_cells[g_head & (kQueueCapacity - 1)];
+    size_t seq = cell.seq.load(std::memory_order_acquire);
+    if (seq != g_head + 1) return false;
+    *out = cell.record;
+    cell.seq.store(g_head + kQueueCapacity, std::memory_order_release);
+    ++g_head;
+    return true;
+}
+
+// uid -> package from packages.list, reloaded when the file changes. Shared uids keep the first.
+class PackageNames {
+public:
+    const char* lookup(int uid) const {
+        auto it = names_.find(uid);
+        return it == names_.end() ? nullptr : it->second.c_str();
+    }
+
+    void refresh() {
+        struct stat st;
+        if (stat(PACKAGES_LIST, &st) != 0 || st.st_mtime == mtime_) return;
+        FILE* f = fopen(PACKAGES_LIST, "re");
+        if (!f) return;
+        mtime_ = st.st_mtime;
+        names_.clear();
+        char line[1024];
+        char name[256];
+        int uid = -1;
+        while (fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "%255s %d", name, &uid) == 2) {
+                names_.emplace(uid, name);
+            }
+        }
+        fclose(f);
+    }
+
+private:
+    time_t mtime_ = 0;
+    std::unordered_map<int, std::string> names_;
+};
+
+class AuditFile {
+public:
+    void append(const std::string& buf) {
+        if (buf.empty()) return;
+        if (fd_ < 0 && !open_log()) return;
+        if (size_ + static_cast<off_t>(buf.size()) > kMaxLogBytes) {
+            rotate();
+            if (fd_ < 0) return;
+        }
+        const char* p = buf.data();
+        size_t left = buf.size();
+        while (left > 0) {
+            ssize_t n = write(fd_, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                logw("audit log write failed: %s", strerror(errno));
+                close(fd_);
+                fd_ = -1;
+                return;
+            }
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        size_ += static_cast<off_t>(buf.size());
+        fdatasync(fd_);
+    }
+
+private:
+    bool open_log() {
+        // customize.sh creates it at install; system_server owns /data/system and can recreate it
+        mkdir(AUDIT_LOG_DIR, 0700);
+        fd_ = open(AUDIT_LOG_PATH, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+        if (fd_ < 0) {
+            if (!warned_) logw("audit log open failed: %s", strerror(errno));
+            warned_ = true;
+            return false;
+        }
+        struct stat st;
+        size_ = fstat(fd_, &st) == 0 ? st.st_size : 0;
+        return true;
+    }
+
+    void rotate() {
+        close(fd_);
+        fd_ = -1;
+        rename(AUDIT_LOG_PATH, AUDIT_LOG_ROTATED_PATH);
+        open_log();
+    }
+
+    int fd_ = -1;
+    off_t size_ = 0;
+    bool warned_ = false;
+};
+
+static void writer_main() {
+    PackageNames packages;
+    AuditFile file;
+    std::string batch;
+    uint64_t reported_drops = 0;
+    char line[384];
+
+    for (;;) {
+        usleep(kFlushIntervalUs);
+        batch.clear();
+        packages.refresh();
+        AuditRecord r;
+        while (pop(&r)) {
+            size_t n = formatAuditLine(r, packages.lookup(r.uid), line, sizeof(line));
+            batch.append(line, n);
+        }
+        file.append(batch);
+
+        uint64_t dropped = g_dropped.load(std::memory_order_relaxed);
+        if (dropped != reported_drops) {
+            logw("audit log queue full, dropped %llu records", (unsigned long long) (dropped - reported_drops));
+            reported_drops = dropped;
+        }
+    }
+}
+
+}  // namespace murasaki::bridge
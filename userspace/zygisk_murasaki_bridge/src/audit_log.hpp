@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace murasaki::bridge {
+
+// Append-only audit trail of MRSK decisions. Binder threads push fixed-size records into a
+// lock-free ring (dropping, never blocking, when it is full); a background writer resolves package
+// names from packages.list and group-commits one line per record to a size-bounded rotating file.
+
+static constexpr const char* AUDIT_LOG_DIR = "/data/system/murasaki_bridge";
+static constexpr const char* AUDIT_LOG_PATH = "/data/system/murasaki_bridge/audit.log";
+static constexpr const char* AUDIT_LOG_ROTATED_PATH = "/data/system/murasaki_bridge/audit.log.1";
+
+enum class AuditVerdict : uint8_t {
+    Granted = 0,
+    GrantedSession,  // served from the session cache
+    DeniedRateLimit,
+    DeniedAllowlist,
+    DeniedDaemon,
+    DeniedDeclared,
+    ServiceMissing,  // authorized, but the requested service is not registered
+    Count,
+};
+
+struct AuditRecord {
+    int64_t time_ms = 0;  // CLOCK_REALTIME
+    int32_t uid = -1;
+    int32_t pid = 0;
+    int32_t action = 0;
+    uint32_t latency_us = 0;
+    AuditVerdict verdict = AuditVerdict::Granted;
+};
+
+// Hot path: one CAS plus a 32-byte copy. Starts the writer thread on first use.
+void auditLogSubmit(const AuditRecord& record);
+
+int64_t realtimeMs();
+
+// Line format, tab separated:
+//   <time_ms> <uid> <pid> <action> <verdict> <latency_us> <package>
+const char* auditVerdictName(AuditVerdict verdict);
+size_t formatAuditLine(const AuditRecord& record, const char* package, char* buf, size_t size);
+// `package` receives at most package_size - 1 bytes. Returns false for malformed lines.
+bool parseAuditLine(const char* line, AuditRecord* record, char* package, size_t package_size);
+
+}  // namespace murasaki::bridge
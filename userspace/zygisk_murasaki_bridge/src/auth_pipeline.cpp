@@ -0,0 +1,136 @@
+#include "auth_pipeline.hpp"
+
+#include <time.h>
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#include "log.hpp"
+
+#ifndef MURASAKI_AUTH_ORDER
+#define MURASAKI_AUTH_ORDER "ratelimit,allowlist,daemon,declared"
+#endif
+
+namespace murasaki::bridge {
+
+static constexpr AuthStage kFallbackOrder[kAuthStageCount] = {
+    AuthStage::RateLimit,
+    AuthStage::Allowlist,
+    AuthStage::DaemonGrant,
+    AuthStage::Declared,
+};
+
+static constexpr const char* kStageNames[kAuthStageCount] = {
+    "ratelimit",
+    "allowlist",
+    "daemon",
+    "declared",
+};
+
+static constexpr size_t kRateLimitSlots = 128;
+
+struct StageStats {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> denies{0};
+    std::atomic<uint64_t> total_ns{0};
+    std::atomic<uint64_t> max_ns{0};
+};
+
+static StageStats g_stage_stats[kAuthStageCount];
+
+struct RateSlot {
+    int uid = -1;
+    int count = 0;
+    uint64_t window_start_ns = 0;
+};
+
+static std::mutex g_rate_mutex;
+static RateSlot g_rate_slots[kRateLimitSlots];
+
+uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+const char* authStageName(AuthStage stage) {
+    size_t i = static_cast<size_t>(stage);
+    return i < kAuthStageCount ? kStageNames[i] : "?";
+}
+
+AuthOrder parseAuthOrder(const char* spec) {
+    AuthOrder order{};
+    size_t n = 0;
+    bool seen[kAuthStageCount] = {};
+
+    const char* p = spec ? spec : "";
+    while (*p && n < kAuthStageCount) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? static_cast<size_t>(end - p) : strlen(p);
+        for (size_t i = 0; i < kAuthStageCount; ++i) {
+            if (!seen[i] && strlen(kStageNames[i]) == len && strncmp(p, kStageNames[i], len) == 0) {
+                order.stages[n++] = static_cast<AuthStage>(i);
+                seen[i] = true;
+                break;
+            }
+        }
+        if (!end) break;
+        p = end + 1;
+    }
+    // Fail closed: never drop a stage because the spec forgot it
+    for (AuthStage s : kFallbackOrder) {
+        if (!seen[static_cast<size_t>(s)]) {
+            order.stages[n++] = s;
+        }
+    }
+    return order;
+}
+
+const AuthOrder& defaultAuthOrder() {
+    static const AuthOrder order = parseAuthOrder(MURASAKI_AUTH_ORDER);
+    return order;
+}
+
+void recordAuthStage(AuthStage stage, uint64_t elapsed_ns, bool denied) {
+    StageStats& st = g_stage_stats[static_cast<size_t>(stage)];
+    st.calls.fetch_add(1, std::memory_order_relaxed);
+    st.total_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+    if (denied) {
+        st.denies.fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t prev = st.max_ns.load(std::memory_order_relaxed);
+    while (elapsed_ns > prev &&
+           !st.max_ns.compare_exchange_weak(prev, elapsed_ns, std::memory_order_relaxed)) {
+    }
+}
+
+void logAuthStats() {
+    for (size_t i = 0; i < kAuthStageCount; ++i) {
+        const StageStats& st = g_stage_stats[i];
+        uint64_t calls = st.calls.load(std::memory_order_relaxed);
+        if (calls == 0) continue;
+        uint64_t total = st.total_ns.load(std::memory_order_relaxed);
+        logd("auth stage %s: calls=%llu denies=%llu avg=%lluus max=%lluus", kStageNames[i],
+             (unsigned long long) calls, (unsigned long long) st.denies.load(std::memory_order_relaxed),
+             (unsigned long long) (total / calls / 1000),
+             (unsigned long long) (st.max_ns.load(std::memory_order_relaxed) / 1000));
+    }
+}
+
+bool rateLimitAllow(int uid, int per_window, uint64_t window_ns, uint64_t* retry_after_ns) {
+    uint64_t now = monotonicNs();
+    std::lock_guard<std::mutex> lock(g_rate_mutex);
+    RateSlot& slot = g_rate_slots[static_cast<unsigned>(uid) % kRateLimitSlots];
+    if (slot.uid != uid || now - slot.window_start_ns >= window_ns) {
+        // 槽位被其他 uid 占用时直接覆盖：最坏情况是对方窗口被重置，不会误拒
+        slot.uid = uid;
+        slot.count = 0;
+        slot.window_start_ns = now;
+    }
+    if (++slot.count <= per_window) return true;
+    *retry_after_ns = slot.window_start_ns + window_ns - now;
+    return false;
+}
+
+}  // namespace murasaki::bridge
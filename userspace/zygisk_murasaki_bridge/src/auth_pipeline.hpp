@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace murasaki::bridge {
+
+// Authorization stages for an MRSK request. All stages must pass (fail closed); the pipeline
+// runs them in the configured order and stops at the first denial, so cheap stages go first.
+enum class AuthStage : uint8_t {
+    RateLimit = 0,  // in-memory per-uid counter
+    Allowlist,      // Rei/KSU allowlist file
+    DaemonGrant,    // IMurasakiService.isUidGrantedRoot (one transact)
+    Declared,       // PackageManager manifest check (several round trips)
+};
+
+static constexpr size_t kAuthStageCount = 4;
+
+enum class AuthVerdict : uint8_t { Pass, Deny };
+
+struct AuthOrder {
+    AuthStage stages[kAuthStageCount];
+};
+
+// Parse a comma separated stage list, e.g. "ratelimit,allowlist,daemon,declared".
+// Unknown names and duplicates are ignored; stages missing from the spec are appended in
+// default order, so a bad spec can reorder the checks but never disable one.
+AuthOrder parseAuthOrder(const char* spec);
+
+// Order baked in at build time (MURASAKI_AUTH_ORDER).
+const AuthOrder& defaultAuthOrder();
+
+const char* authStageName(AuthStage stage);
+
+// Per-stage cost accounting; cheap enough for the binder thread (relaxed atomics).
+void recordAuthStage(AuthStage stage, uint64_t elapsed_ns, bool denied);
+void logAuthStats();
+
+// Fixed-window per-uid limiter backing AuthStage::RateLimit. On denial *retry_after_ns is the
+// time left in the current window.
+bool rateLimitAllow(int uid, int per_window, uint64_t window_ns, uint64_t* retry_after_ns);
+
+uint64_t monotonicNs();
+
+}  // namespace murasaki::bridge
@@ -1,23 +1,54 @@
 #include "bridge.hpp"
 
-#include <android/log.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <cstdio>
-#include <cstdarg>
 #include <cstdlib>
 #include <cstring>
+#include <mutex>
 #include <string>
+#include <vector>
 
-namespace murasaki::bridge {
+#include "audit_log.hpp"
+#include "auth_pipeline.hpp"
+#include "config.hpp"
+#include "daemon_watchdog.hpp"
+#include "jvm_worker.hpp"
+#include "log.hpp"
+#include "session_cache.hpp"
+#include "trace.hpp"
 
-static constexpr const char* LOG_TAG = "MurasakiBridge";
+namespace murasaki::bridge {
 
 static constexpr jint TRANSACTION_MRSK = ('M' << 24) | ('R' << 16) | ('S' << 8) | 'K';
 static constexpr jint ACTION_GET_SHIZUKU_BINDER = 1;
 static constexpr jint ACTION_GET_MURASAKI_BINDER = 2;
+// Bridge/daemon status for health checks; answered from in-memory state, no authorization
+static constexpr jint ACTION_GET_STATUS = 3;
+
+#ifndef MURASAKI_BRIDGE_VERSION_CODE
+#define MURASAKI_BRIDGE_VERSION_CODE 0
+#endif
+
+// MRSK reply protocol. v1 (Sui compatible): the request is the AMS token plus the action; a
+// granted request gets noException + binder, anything else is left unhandled (transact returns
+// false, empty reply). v2: the client appends its protocol version after the action, and every
+// request with a known action gets noException, version, status, retry-after (ms), binder.
+static constexpr jint MRSK_PROTOCOL_LEGACY = 1;
+static constexpr jint MRSK_PROTOCOL_STATUS = 2;
+
+static constexpr jint MRSK_STATUS_GRANTED = 0;
+static constexpr jint MRSK_STATUS_DENIED_UNDECLARED = 1;
+static constexpr jint MRSK_STATUS_DENIED_POLICY = 2;
+static constexpr jint MRSK_STATUS_NOT_READY = 3;
+static constexpr jint MRSK_STATUS_RATE_LIMITED = 4;
+
+// retry-after hints: the watchdog re-probes a missing daemon every 500ms; the Rei dialog waits on the user
+static constexpr uint32_t kNotReadyRetryAfterMs = 1000;
+static constexpr uint32_t kAuthDialogRetryAfterMs = 5000;
 
 static constexpr const char* AMS_DESCRIPTOR = "android.app.IActivityManager";
 
@@ -25,16 +56,52 @@ static constexpr const char* SERVICE_MURASAKI = "io.murasaki.IMurasakiService";
 static constexpr const char* SERVICE_SHIZUKU = "user_service";
 static constexpr const char* SERVICE_SHIZUKU_FALLBACK = "moe.shizuku.server.IShizukuService";
 
+static constexpr size_t kMaxServiceCandidates = 3;
+static constexpr uint32_t kAllAuthStages = (1u << kAuthStageCount) - 1;
+
+// MRSK action -> ServiceManager names (tried in order) and the auth stages it requires.
+// Bridging a new binder type only needs a row here.
+struct ActionSpec {
+    jint action;
+    const char* services[kMaxServiceCandidates];
+    uint32_t required_stages;
+};
+
+static constexpr ActionSpec kActionTable[] = {
+    {ACTION_GET_SHIZUKU_BINDER, {SERVICE_SHIZUKU, SERVICE_SHIZUKU_FALLBACK}, kAllAuthStages},
+    {ACTION_GET_MURASAKI_BINDER, {SERVICE_MURASAKI}, kAllAuthStages},
+};
+
+static constexpr size_t kActionCount = sizeof(kActionTable) / sizeof(kActionTable[0]);
+
+static constexpr size_t action_index(jint action) {
+    for (size_t i = 0; i < kActionCount; ++i) {
+        if (kActionTable[i].action == action) return i;
+    }
+    return kActionCount;
+}
+
+// The daemon grant stage resolves the Murasaki binder through the same cached slot.
+static constexpr size_t kMurasakiSlot = action_index(ACTION_GET_MURASAKI_BINDER);
+static_assert(kMurasakiSlot < kActionCount, "Murasaki action must be registered");
+
 static constexpr const char* MURASAKI_AIDL_DESCRIPTOR = "io.murasaki.server.IMurasakiService";
 static constexpr jint MURASAKI_TX_isUidGrantedRoot = 11;
+// getUidsGrantedRoot(in int[] uids) -> int[] bitmap, bit (i % 32) of word i / 32 set when uids[i] is
+// granted. Declared with the explicit AIDL id 1000 so it cannot collide with the daemon's
+// sequentially numbered methods, and used only when the daemon reports an interface version of at
+// least kBulkGrantMinInterfaceVersion; otherwise the bridge asks uid by uid.
+static constexpr jint MURASAKI_TX_getUidsGrantedRoot = 1 + 1000;  // FIRST_CALL_TRANSACTION + id
+// Stable AIDL getInterfaceVersion() (IBinder.LAST_CALL_TRANSACTION); unversioned stubs reject it
+static constexpr jint MURASAKI_TX_getInterfaceVersion = 0x00ffffff;
+static constexpr jint kBulkGrantMinInterfaceVersion = 2;
 
 static constexpr const char* SHIZUKU_API_PERMISSION_PREFIX = "moe.shizuku.manager.permission.API";
 static constexpr const char* SHIZUKU_V3_META = "moe.shizuku.client.V3_SUPPORT";
 static constexpr const char* MURASAKI_META = "io.murasaki.client.SUPPORT";
 
-// Rei 优先：桥接读取白名单时先试 Rei 目录，兼容 YukiSU 旧路径
-static constexpr const char* ALLOWLIST_REI = "/data/adb/rei/.murasaki_allowlist";
-static constexpr const char* ALLOWLIST_KSU = "/data/adb/ksu/.murasaki_allowlist";
+// 每处理多少次 MRSK 请求输出一次各鉴权阶段耗时统计（须为 2 的幂）
+static constexpr uint32_t kAuthStatsLogInterval = 64;
 
 static ExecTransact_t g_orig_execTransact = nullptr;
 
@@ -56,6 +123,9 @@ static jmethodID g_mid_Parcel_writeInt = nullptr;
 static jmethodID g_mid_Parcel_writeNoException = nullptr;
 static jmethodID g_mid_Parcel_writeStrongBinder = nullptr;
 static jmethodID g_mid_Parcel_readException = nullptr;
+static jmethodID g_mid_Parcel_dataAvail = nullptr;
+static jmethodID g_mid_Parcel_writeIntArray = nullptr;   // bulk grant query
+static jmethodID g_mid_Parcel_createIntArray = nullptr;
 
 static jclass g_cls_ServiceManager = nullptr;
 static jmethodID g_mid_SM_getService = nullptr;
@@ -63,6 +133,22 @@ static jmethodID g_mid_SM_getService = nullptr;
 static jclass g_cls_IBinder = nullptr;
 static jmethodID g_mid_IBinder_transact = nullptr;
 static jmethodID g_mid_IBinder_pingBinder = nullptr;
+static jmethodID g_mid_IBinder_isBinderAlive = nullptr;
+
+// isBinderAlive() only turns false after a linked death notification or a failed transact on the
+// proxy; nothing links to e.g. the Shizuku binder, so a cached binder is pinged at this interval.
+static constexpr uint64_t kBinderRevalidateNs = 1000000000ull;  // 1s
+
+// Resolved binder per kActionTable row (global ref), dropped once the remote dies.
+struct ActionSlot {
+    std::mutex lock;
+    jobject binder = nullptr;
+    std::atomic<uint64_t> checked_ns{0};  // last successful ping of `binder`
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+static ActionSlot g_action_slots[kActionCount];
 
 static jclass g_cls_ActivityThread = nullptr;
 static jmethodID g_mid_AT_currentActivityThread = nullptr;
@@ -108,30 +194,16 @@ static constexpr const char* EXTRA_UID = "rei.extra.UID";
 static constexpr const char* EXTRA_SOURCE = "rei.extra.SOURCE";
 static constexpr const char* SOURCE_MURASAKI = "murasaki";
 
-static inline void logd(const char* fmt, ...) {
-    va_list ap;
-    va_start(ap, fmt);
-    __android_log_vprint(ANDROID_LOG_DEBUG, LOG_TAG, fmt, ap);
-    va_end(ap);
-}
-
-static inline void logw(const char* fmt, ...) {
-    va_list ap;
-    va_start(ap, fmt);
-    __android_log_vprint(ANDROID_LOG_WARN, LOG_TAG, fmt, ap);
-    va_end(ap);
-}
-
 static void clear_exc(JNIEnv* env) {
     if (env->ExceptionCheck()) {
         env->ExceptionClear();
     }
 }
 
-// Rei 优先：若任一白名单文件存在且可读，则 calling_uid 必须在其中；无文件或不可读时返回 true（交给 daemon）
-static bool allowlist_file_contains_uid(jint calling_uid) {
-    for (const char* path : {ALLOWLIST_REI, ALLOWLIST_KSU}) {
-        FILE* f = fopen(path, "r");
+// Rei 优先（配置 allowlist 的顺序）：若任一白名单文件存在且可读，则 calling_uid 必须在其中；无文件或不可读时返回 true（交给 daemon）
+static bool allowlist_file_contains_uid(const BridgeConfig& cfg, jint calling_uid) {
+    for (const std::string& path : cfg.allowlist_paths) {
+        FILE* f = fopen(path.c_str(), "r");
         if (!f) continue;
         bool found = false;
         char line[64];
@@ -149,115 +221,231 @@ static bool allowlist_file_contains_uid(jint calling_uid) {
     return true;  // 无文件或不可读时交给 daemon
 }
 
-static bool ensure_cache(JNIEnv* env) {
-    if (g_cls_Binder) {
+// JNI bindings, resolved per group on first use. Core serves every MRSK request; Packages only
+// the declared-client check and package lookups; AuthDialog only the rare Rei dialog path.
+enum class JniGroup : uint8_t {
+    Core = 0,
+    Packages,
+    AuthDialog,
+    Count,
+};
+
+static constexpr size_t kJniGroupCount = static_cast<size_t>(JniGroup::Count);
+
+struct JniGroupSpec {
+    const char* name;
+    JniGroup depends_on;  // resolved first (its classes are shared); Count for none
+};
+
+static constexpr JniGroupSpec kJniGroups[kJniGroupCount] = {
+    {"core", JniGroup::Count},
+    {"packages", JniGroup::Count},
+    {"auth_dialog", JniGroup::Packages},  // android.content.Context
+};
+
+struct ClassBinding {
+    JniGroup group;
+    const char* name;
+    jclass* out;
+};
+
+enum class MemberKind : uint8_t { Method, StaticMethod, Field, StaticField };
+
+struct MemberBinding {
+    JniGroup group;
+    jclass* cls;
+    MemberKind kind;
+    const char* name;
+    const char* sig;
+    jmethodID* mid;  // Method / StaticMethod
+    jfieldID* fid;   // Field / StaticField
+    bool optional;   // callers cope with null
+};
+
+static constexpr MemberBinding method(JniGroup g, jclass* cls, const char* name, const char* sig, jmethodID* out,
+                                      bool optional = false) {
+    return {g, cls, MemberKind::Method, name, sig, out, nullptr, optional};
+}
+
+static constexpr MemberBinding static_method(JniGroup g, jclass* cls, const char* name, const char* sig,
+                                             jmethodID* out) {
+    return {g, cls, MemberKind::StaticMethod, name, sig, out, nullptr, false};
+}
+
+static constexpr MemberBinding field(JniGroup g, jclass* cls, const char* name, const char* sig, jfieldID* out) {
+    return {g, cls, MemberKind::Field, name, sig, nullptr, out, false};
+}
+
+static constexpr MemberBinding static_field(JniGroup g, jclass* cls, const char* name, const char* sig,
+                                            jfieldID* out) {
+    return {g, cls, MemberKind::StaticField, name, sig, nullptr, out, false};
+}
+
+static constexpr ClassBinding kJniClasses[] = {
+    {JniGroup::Core, "android/os/Binder", &g_cls_Binder},
+    {JniGroup::Core, "android/os/Parcel", &g_cls_Parcel},
+    {JniGroup::Core, "android/os/ServiceManager", &g_cls_ServiceManager},
+    {JniGroup::Core, "android/os/IBinder", &g_cls_IBinder},
+    // ActivityThread is hidden, but JNI can still call it
+    {JniGroup::Packages, "android/app/ActivityThread", &g_cls_ActivityThread},
+    {JniGroup::Packages, "android/content/Context", &g_cls_Context},
+    {JniGroup::Packages, "android/content/pm/PackageManager", &g_cls_PackageManager},
+    {JniGroup::Packages, "android/content/pm/PackageInfo", &g_cls_PackageInfo},
+    {JniGroup::Packages, "android/content/pm/ApplicationInfo", &g_cls_ApplicationInfo},
+    {JniGroup::Packages, "android/os/Bundle", &g_cls_Bundle},
+    {JniGroup::Packages, "java/lang/String", &g_cls_String},
+    {JniGroup::AuthDialog, "android/content/Intent", &g_cls_Intent},
+};
+
+static constexpr MemberBinding kJniMembers[] = {
+    static_method(JniGroup::Core, &g_cls_Binder, "getCallingUid", "()I", &g_mid_getCallingUid),
+    static_method(JniGroup::Core, &g_cls_Binder, "getCallingPid", "()I", &g_mid_getCallingPid),
+
+    static_method(JniGroup::Core, &g_cls_Parcel, "obtain", "(J)Landroid/os/Parcel;", &g_mid_Parcel_obtainPtr),
+    static_method(JniGroup::Core, &g_cls_Parcel, "obtain", "()Landroid/os/Parcel;", &g_mid_Parcel_obtain),
+    method(JniGroup::Core, &g_cls_Parcel, "recycle", "()V", &g_mid_Parcel_recycle),
+    method(JniGroup::Core, &g_cls_Parcel, "setDataPosition", "(I)V", &g_mid_Parcel_setDataPosition),
+    method(JniGroup::Core, &g_cls_Parcel, "enforceInterface", "(Ljava/lang/String;)V", &g_mid_Parcel_enforceInterface),
+    method(JniGroup::Core, &g_cls_Parcel, "readInt", "()I", &g_mid_Parcel_readInt),
+    method(JniGroup::Core, &g_cls_Parcel, "readByte", "()B", &g_mid_Parcel_readByte, true),
+    method(JniGroup::Core, &g_cls_Parcel, "readString", "()Ljava/lang/String;", &g_mid_Parcel_readString),
+    method(JniGroup::Core, &g_cls_Parcel, "writeInterfaceToken", "(Ljava/lang/String;)V",
+           &g_mid_Parcel_writeInterfaceToken),
+    method(JniGroup::Core, &g_cls_Parcel, "writeInt", "(I)V", &g_mid_Parcel_writeInt),
+    method(JniGroup::Core, &g_cls_Parcel, "writeNoException", "()V", &g_mid_Parcel_writeNoException),
+    method(JniGroup::Core, &g_cls_Parcel, "writeStrongBinder", "(Landroid/os/IBinder;)V",
+           &g_mid_Parcel_writeStrongBinder),
+    method(JniGroup::Core, &g_cls_Parcel, "readException", "()V", &g_mid_Parcel_readException),
+    method(JniGroup::Core, &g_cls_Parcel, "dataAvail", "()I", &g_mid_Parcel_dataAvail),
+    method(JniGroup::Core, &g_cls_Parcel, "writeIntArray", "([I)V", &g_mid_Parcel_writeIntArray, true),
+    method(JniGroup::Core, &g_cls_Parcel, "createIntArray", "()[I", &g_mid_Parcel_createIntArray, true),
+
+    static_method(JniGroup::Core, &g_cls_ServiceManager, "getService", "(Ljava/lang/String;)Landroid/os/IBinder;",
+                  &g_mid_SM_getService),
+
+    method(JniGroup::Core, &g_cls_IBinder, "transact", "(ILandroid/os/Parcel;Landroid/os/Parcel;I)Z",
+           &g_mid_IBinder_transact),
+    method(JniGroup::Core, &g_cls_IBinder, "pingBinder", "()Z", &g_mid_IBinder_pingBinder),
+    method(JniGroup::Core, &g_cls_IBinder, "isBinderAlive", "()Z", &g_mid_IBinder_isBinderAlive),
+
+    static_method(JniGroup::Packages, &g_cls_ActivityThread, "currentActivityThread", "()Landroid/app/ActivityThread;",
+                  &g_mid_AT_currentActivityThread),
+    method(JniGroup::Packages, &g_cls_ActivityThread, "getSystemContext", "()Landroid/content/Context;",
+           &g_mid_AT_getSystemContext),
+    method(JniGroup::Packages, &g_cls_Context, "getPackageManager", "()Landroid/content/pm/PackageManager;",
+           &g_mid_Context_getPackageManager),
+    method(JniGroup::Packages, &g_cls_PackageManager, "getPackagesForUid", "(I)[Ljava/lang/String;",
+           &g_mid_PM_getPackagesForUid),
+    method(JniGroup::Packages, &g_cls_PackageManager, "getPackageInfo",
+           "(Ljava/lang/String;I)Landroid/content/pm/PackageInfo;", &g_mid_PM_getPackageInfo),
+    method(JniGroup::Packages, &g_cls_PackageManager, "getApplicationInfo",
+           "(Ljava/lang/String;I)Landroid/content/pm/ApplicationInfo;", &g_mid_PM_getApplicationInfo),
+    static_field(JniGroup::Packages, &g_cls_PackageManager, "GET_PERMISSIONS", "I", &g_fid_PM_GET_PERMISSIONS),
+    static_field(JniGroup::Packages, &g_cls_PackageManager, "GET_META_DATA", "I", &g_fid_PM_GET_META_DATA),
+    field(JniGroup::Packages, &g_cls_PackageInfo, "requestedPermissions", "[Ljava/lang/String;",
+          &g_fid_PackageInfo_requestedPermissions),
+    field(JniGroup::Packages, &g_cls_ApplicationInfo, "metaData", "Landroid/os/Bundle;",
+          &g_fid_ApplicationInfo_metaData),
+    method(JniGroup::Packages, &g_cls_Bundle, "getBoolean", "(Ljava/lang/String;Z)Z", &g_mid_Bundle_getBoolean),
+    method(JniGroup::Packages, &g_cls_String, "startsWith", "(Ljava/lang/String;)Z", &g_mid_String_startsWith),
+
+    method(JniGroup::AuthDialog, &g_cls_Intent, "<init>", "()V", &g_mid_Intent_init),
+    method(JniGroup::AuthDialog, &g_cls_Intent, "setClassName",
+           "(Ljava/lang/String;Ljava/lang/String;)Landroid/content/Intent;", &g_mid_Intent_setClassName),
+    method(JniGroup::AuthDialog, &g_cls_Intent, "putExtra",
+           "(Ljava/lang/String;Ljava/lang/String;)Landroid/content/Intent;", &g_mid_Intent_putExtra_SS),
+    method(JniGroup::AuthDialog, &g_cls_Intent, "putExtra", "(Ljava/lang/String;I)Landroid/content/Intent;",
+           &g_mid_Intent_putExtra_SI),
+    method(JniGroup::AuthDialog, &g_cls_Intent, "addFlags", "(I)Landroid/content/Intent;", &g_mid_Intent_addFlags),
+    method(JniGroup::AuthDialog, &g_cls_Context, "startActivity", "(Landroid/content/Intent;)V",
+           &g_mid_Context_startActivity),
+};
+
+enum : uint8_t { kJniUnresolved = 0, kJniReady, kJniFailed };
+
+// Published with release once every binding of the group is written; failures are sticky.
+static std::atomic<uint8_t> g_jni_state[kJniGroupCount];
+static std::mutex g_jni_mutex;
+
+// Failed lookups throw (ClassNotFoundError/NoSuchMethodError); clear so nothing stays pending.
+static bool lookup_failed(JNIEnv* env, bool missing) {
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
         return true;
     }
+    return missing;
+}
 
-    auto make_global = [&](jclass local) -> jclass {
-        if (!local) return nullptr;
-        jclass g = (jclass) env->NewGlobalRef(local);
+static bool resolve_jni_group(JNIEnv* env, JniGroup group) {
+    size_t failed = 0;
+    for (const ClassBinding& c : kJniClasses) {
+        if (c.group != group) continue;
+        jclass local = env->FindClass(c.name);
+        if (lookup_failed(env, !local)) {
+            logw("jni: class %s not found", c.name);
+            ++failed;
+            continue;
+        }
+        *c.out = (jclass) env->NewGlobalRef(local);
         env->DeleteLocalRef(local);
-        return g;
-    };
-
-    // android.os.Binder
-    g_cls_Binder = make_global(env->FindClass("android/os/Binder"));
-    if (!g_cls_Binder) return false;
-    g_mid_getCallingUid = env->GetStaticMethodID(g_cls_Binder, "getCallingUid", "()I");
-    g_mid_getCallingPid = env->GetStaticMethodID(g_cls_Binder, "getCallingPid", "()I");
-
-    // android.os.Parcel
-    g_cls_Parcel = make_global(env->FindClass("android/os/Parcel"));
-    if (!g_cls_Parcel) return false;
-    g_mid_Parcel_obtainPtr = env->GetStaticMethodID(g_cls_Parcel, "obtain", "(J)Landroid/os/Parcel;");
-    g_mid_Parcel_obtain = env->GetStaticMethodID(g_cls_Parcel, "obtain", "()Landroid/os/Parcel;");
-    g_mid_Parcel_recycle = env->GetMethodID(g_cls_Parcel, "recycle", "()V");
-    g_mid_Parcel_setDataPosition = env->GetMethodID(g_cls_Parcel, "setDataPosition", "(I)V");
-    g_mid_Parcel_enforceInterface = env->GetMethodID(g_cls_Parcel, "enforceInterface", "(Ljava/lang/String;)V");
-    g_mid_Parcel_readInt = env->GetMethodID(g_cls_Parcel, "readInt", "()I");
-    g_mid_Parcel_readByte = env->GetMethodID(g_cls_Parcel, "readByte", "()B");
-    g_mid_Parcel_readString = env->GetMethodID(g_cls_Parcel, "readString", "()Ljava/lang/String;");
-    g_mid_Parcel_writeInterfaceToken = env->GetMethodID(g_cls_Parcel, "writeInterfaceToken", "(Ljava/lang/String;)V");
-    g_mid_Parcel_writeInt = env->GetMethodID(g_cls_Parcel, "writeInt", "(I)V");
-    g_mid_Parcel_writeNoException = env->GetMethodID(g_cls_Parcel, "writeNoException", "()V");
-    g_mid_Parcel_writeStrongBinder = env->GetMethodID(g_cls_Parcel, "writeStrongBinder", "(Landroid/os/IBinder;)V");
-    g_mid_Parcel_readException = env->GetMethodID(g_cls_Parcel, "readException", "()V");
-
-    // android.os.ServiceManager
-    g_cls_ServiceManager = make_global(env->FindClass("android/os/ServiceManager"));
-    if (!g_cls_ServiceManager) return false;
-    g_mid_SM_getService =
-        env->GetStaticMethodID(g_cls_ServiceManager, "getService", "(Ljava/lang/String;)Landroid/os/IBinder;");
-
-    // android.os.IBinder
-    g_cls_IBinder = make_global(env->FindClass("android/os/IBinder"));
-    if (!g_cls_IBinder) return false;
-    g_mid_IBinder_transact = env->GetMethodID(g_cls_IBinder, "transact", "(ILandroid/os/Parcel;Landroid/os/Parcel;I)Z");
-    g_mid_IBinder_pingBinder = env->GetMethodID(g_cls_IBinder, "pingBinder", "()Z");
-
-    // android.app.ActivityThread (hidden, but JNI can still call)
-    g_cls_ActivityThread = make_global(env->FindClass("android/app/ActivityThread"));
-    if (!g_cls_ActivityThread) return false;
-    g_mid_AT_currentActivityThread = env->GetStaticMethodID(g_cls_ActivityThread, "currentActivityThread",
-                                                           "()Landroid/app/ActivityThread;");
-    g_mid_AT_getSystemContext = env->GetMethodID(g_cls_ActivityThread, "getSystemContext", "()Landroid/content/Context;");
-
-    // android.content.Context
-    g_cls_Context = make_global(env->FindClass("android/content/Context"));
-    if (!g_cls_Context) return false;
-    g_mid_Context_getPackageManager =
-        env->GetMethodID(g_cls_Context, "getPackageManager", "()Landroid/content/pm/PackageManager;");
-
-    // android.content.pm.PackageManager
-    g_cls_PackageManager = make_global(env->FindClass("android/content/pm/PackageManager"));
-    if (!g_cls_PackageManager) return false;
-    g_mid_PM_getPackagesForUid = env->GetMethodID(g_cls_PackageManager, "getPackagesForUid", "(I)[Ljava/lang/String;");
-    g_mid_PM_getPackageInfo = env->GetMethodID(g_cls_PackageManager, "getPackageInfo",
-                                               "(Ljava/lang/String;I)Landroid/content/pm/PackageInfo;");
-    g_mid_PM_getApplicationInfo = env->GetMethodID(g_cls_PackageManager, "getApplicationInfo",
-                                                   "(Ljava/lang/String;I)Landroid/content/pm/ApplicationInfo;");
-    g_fid_PM_GET_PERMISSIONS = env->GetStaticFieldID(g_cls_PackageManager, "GET_PERMISSIONS", "I");
-    g_fid_PM_GET_META_DATA = env->GetStaticFieldID(g_cls_PackageManager, "GET_META_DATA", "I");
-
-    // android.content.pm.PackageInfo
-    g_cls_PackageInfo = make_global(env->FindClass("android/content/pm/PackageInfo"));
-    if (!g_cls_PackageInfo) return false;
-    g_fid_PackageInfo_requestedPermissions = env->GetFieldID(g_cls_PackageInfo, "requestedPermissions", "[Ljava/lang/String;");
-
-    // android.content.pm.ApplicationInfo
-    g_cls_ApplicationInfo = make_global(env->FindClass("android/content/pm/ApplicationInfo"));
-    if (!g_cls_ApplicationInfo) return false;
-    g_fid_ApplicationInfo_metaData = env->GetFieldID(g_cls_ApplicationInfo, "metaData", "Landroid/os/Bundle;");
-
-    // android.os.Bundle
-    g_cls_Bundle = make_global(env->FindClass("android/os/Bundle"));
-    if (!g_cls_Bundle) return false;
-    g_mid_Bundle_getBoolean = env->GetMethodID(g_cls_Bundle, "getBoolean", "(Ljava/lang/String;Z)Z");
-
-    // java.lang.String
-    g_cls_String = make_global(env->FindClass("java/lang/String"));
-    if (!g_cls_String) return false;
-    g_mid_String_startsWith = env->GetMethodID(g_cls_String, "startsWith", "(Ljava/lang/String;)Z");
-
-    // android.content.Intent (for launching Rei AuthorizeActivity)
-    g_cls_Intent = make_global(env->FindClass("android/content/Intent"));
-    if (!g_cls_Intent) return false;
-    g_mid_Intent_init = env->GetMethodID(g_cls_Intent, "<init>", "()V");
-    g_mid_Intent_setClassName =
-        env->GetMethodID(g_cls_Intent, "setClassName", "(Ljava/lang/String;Ljava/lang/String;)Landroid/content/Intent;");
-    g_mid_Intent_putExtra_SS =
-        env->GetMethodID(g_cls_Intent, "putExtra", "(Ljava/lang/String;Ljava/lang/String;)Landroid/content/Intent;");
-    g_mid_Intent_putExtra_SI = env->GetMethodID(g_cls_Intent, "putExtra", "(Ljava/lang/String;I)Landroid/content/Intent;");
-    g_mid_Intent_addFlags = env->GetMethodID(g_cls_Intent, "addFlags", "(I)Landroid/content/Intent;");
-    g_mid_Context_startActivity = env->GetMethodID(g_cls_Context, "startActivity", "(Landroid/content/Intent;)V");
+    }
+    for (const MemberBinding& m : kJniMembers) {
+        if (m.group != group) continue;
+        bool missing = true;
+        if (*m.cls) {
+            switch (m.kind) {
+                case MemberKind::Method:
+                    *m.mid = env->GetMethodID(*m.cls, m.name, m.sig);
+                    missing = !*m.mid;
+                    break;
+                case MemberKind::StaticMethod:
+                    *m.mid = env->GetStaticMethodID(*m.cls, m.name, m.sig);
+                    missing = !*m.mid;
+                    break;
+                case MemberKind::Field:
+                    *m.fid = env->GetFieldID(*m.cls, m.name, m.sig);
+                    missing = !*m.fid;
+                    break;
+                case MemberKind::StaticField:
+                    *m.fid = env->GetStaticFieldID(*m.cls, m.name, m.sig);
+                    missing = !*m.fid;
+                    break;
+            }
+        }
+        if (lookup_failed(env, missing)) {
+            logw("jni: %s %s%s unresolved%s", kJniGroups[static_cast<size_t>(group)].name, m.name, m.sig,
+                 m.optional ? " (optional)" : "");
+            if (!m.optional) ++failed;
+        }
+    }
+    if (failed) {
+        logw("jni: group %s disabled, %zu binding(s) failed", kJniGroups[static_cast<size_t>(group)].name, failed);
+    }
+    return failed == 0;
+}
 
-    clear_exc(env);
-    return true;
+// Resolves `group` (and the group it requires) on first use. Hot path: one acquire load.
+static bool ensure_jni(JNIEnv* env, JniGroup group) {
+    std::atomic<uint8_t>& state = g_jni_state[static_cast<size_t>(group)];
+    uint8_t s = state.load(std::memory_order_acquire);
+    if (s != kJniUnresolved) return s == kJniReady;
+
+    JniGroup depends_on = kJniGroups[static_cast<size_t>(group)].depends_on;
+    if (depends_on != JniGroup::Count && !ensure_jni(env, depends_on)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(g_jni_mutex);
+    s = state.load(std::memory_order_relaxed);
+    if (s == kJniUnresolved) {
+        s = resolve_jni_group(env, group) ? kJniReady : kJniFailed;
+        state.store(s, std::memory_order_release);
+    }
+    return s == kJniReady;
 }
 
 // Returns first package name for uid, or empty string. Caller must DeleteLocalRef the jstring if non-null returned as jobject.
 static std::string get_first_package_for_uid(JNIEnv* env, jint uid) {
+    if (!ensure_jni(env, JniGroup::Packages)) return {};
     jobject at = env->CallStaticObjectMethod(g_cls_ActivityThread, g_mid_AT_currentActivityThread);
     if (env->ExceptionCheck() || !at) {
         clear_exc(env);
@@ -298,7 +486,7 @@ static std::string get_first_package_for_uid(JNIEnv* env, jint uid) {
 
 // Launch Rei's AuthorizeActivity for Murasaki grant. System context can start exported=false activity.
 static void launch_rei_murasaki_auth(JNIEnv* env, jint uid, const std::string& packageName) {
-    if (packageName.empty() || !g_mid_Context_startActivity || !g_mid_Intent_setClassName) return;
+    if (packageName.empty() || !ensure_jni(env, JniGroup::AuthDialog)) return;
     jobject at = env->CallStaticObjectMethod(g_cls_ActivityThread, g_mid_AT_currentActivityThread);
     if (env->ExceptionCheck() || !at) {
         clear_exc(env);
@@ -378,8 +566,72 @@ static jobject sm_get_service(JNIEnv* env, const char* name) {
     return b;
 }
 
+// Drops the slot's cached binder if it is still `dead` (another thread may have replaced it).
+static void drop_action_binder(JNIEnv* env, size_t idx, jobject dead) {
+    ActionSlot& slot = g_action_slots[idx];
+    std::lock_guard<std::mutex> lock(slot.lock);
+    if (slot.binder && env->IsSameObject(slot.binder, dead)) {
+        env->DeleteGlobalRef(slot.binder);
+        slot.binder = nullptr;
+    }
+}
+
+// Returns a local ref to the binder for kActionTable[idx], from the slot cache when the cached
+// binder is still alive, otherwise by walking the service candidates. May return null.
+static jobject resolve_action_binder(JNIEnv* env, size_t idx) {
+    ActionSlot& slot = g_action_slots[idx];
+    jobject cached = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(slot.lock);
+        if (slot.binder) cached = env->NewLocalRef(slot.binder);
+    }
+    if (cached) {
+        // 通常只查本地状态 isBinderAlive（无 IPC）；每个间隔由一个线程 ping 一次远端
+        uint64_t now = monotonicNs();
+        uint64_t checked = slot.checked_ns.load(std::memory_order_relaxed);
+        bool ping = now - checked >= kBinderRevalidateNs &&
+                    slot.checked_ns.compare_exchange_strong(checked, now, std::memory_order_relaxed);
+        jboolean alive = env->CallBooleanMethod(cached, ping ? g_mid_IBinder_pingBinder : g_mid_IBinder_isBinderAlive);
+        if (env->ExceptionCheck()) {
+            clear_exc(env);
+            alive = JNI_FALSE;
+        }
+        if (alive) {
+            slot.hits.fetch_add(1, std::memory_order_relaxed);
+            return cached;
+        }
+        drop_action_binder(env, idx, cached);
+        env->DeleteLocalRef(cached);
+    }
+
+    slot.misses.fetch_add(1, std::memory_order_relaxed);
+    jobject b = nullptr;
+    for (const char* name : kActionTable[idx].services) {
+        if (!name) break;
+        b = sm_get_service(env, name);
+        if (b) break;
+    }
+    if (b) {
+        std::lock_guard<std::mutex> lock(slot.lock);
+        if (!slot.binder) {
+            slot.binder = env->NewGlobalRef(b);
+            slot.checked_ns.store(monotonicNs(), std::memory_order_relaxed);  // sm_get_service pinged it
+        }
+    }
+    return b;
+}
+
+static void log_action_stats() {
+    for (size_t i = 0; i < kActionCount; ++i) {
+        logd("action %d binder cache: hits=%llu misses=%llu", kActionTable[i].action,
+             (unsigned long long) g_action_slots[i].hits.load(std::memory_order_relaxed),
+             (unsigned long long) g_action_slots[i].misses.load(std::memory_order_relaxed));
+    }
+}
+
 static bool is_declared_client(JNIEnv* env, jint uid) {
     // requestedPermissions prefix OR meta-data flags.
+    if (!ensure_jni(env, JniGroup::Packages)) return false;
     jobject at = env->CallStaticObjectMethod(g_cls_ActivityThread, g_mid_AT_currentActivityThread);
     if (env->ExceptionCheck()) {
         clear_exc(env);
@@ -491,16 +743,24 @@ static bool is_declared_client(JNIEnv* env, jint uid) {
     return declared;
 }
 
-static bool murasaki_is_uid_allowed(JNIEnv* env, jobject murasaki_binder, jint uid) {
+// Outcome of asking the daemon: CallFailed (dead binder, failed transact) is not an answer and
+// must not be reported to clients as a policy denial.
+enum class DaemonAnswer : uint8_t {
+    Granted,
+    Denied,
+    CallFailed,
+};
+
+static DaemonAnswer murasaki_is_uid_allowed(JNIEnv* env, jobject murasaki_binder, jint uid) {
     // Call IMurasakiService.isUidGrantedRoot(uid) via raw transact
-    if (!murasaki_binder) return false;
+    if (!murasaki_binder) return DaemonAnswer::CallFailed;
 
     jobject data = parcel_obtain(env);
     jobject reply = parcel_obtain(env);
     if (!data || !reply) {
         if (data) env->DeleteLocalRef(data);
         if (reply) env->DeleteLocalRef(reply);
-        return false;
+        return DaemonAnswer::CallFailed;
     }
 
     jstring desc = env->NewStringUTF(MURASAKI_AIDL_DESCRIPTOR);
@@ -542,132 +802,632 @@ static bool murasaki_is_uid_allowed(JNIEnv* env, jobject murasaki_binder, jint u
     env->CallVoidMethod(reply, g_mid_Parcel_recycle);
     env->DeleteLocalRef(data);
     env->DeleteLocalRef(reply);
-    return allowed;
+    if (!ok) return DaemonAnswer::CallFailed;
+    return allowed ? DaemonAnswer::Granted : DaemonAnswer::Denied;
 }
 
-static bool handle_bridge(JNIEnv* env, jint code, jlong dataObj, jlong replyObj) {
-    if (code != TRANSACTION_MRSK) {
-        return false;
-    }
-    if (!ensure_cache(env)) {
-        return false;
-    }
+// Bulk support of the daemon binder seen last: the version is asked once per daemon instance.
+static std::mutex g_bulk_cap_lock;
+static jobject g_bulk_cap_binder = nullptr;  // global ref
+static bool g_bulk_cap_supported = false;
 
-    jobject data = parcel_from_ptr(env, dataObj);
-    jobject reply = parcel_from_ptr(env, replyObj);
-    if (!data) {
+// IMurasakiService.getInterfaceVersion(): 0 when the daemon's interface is unversioned (the code is
+// rejected), -1 when the call failed (dead binder).
+static jint murasaki_interface_version(JNIEnv* env, jobject murasaki_binder) {
+    jobject data = parcel_obtain(env);
+    jobject reply = parcel_obtain(env);
+    if (!data || !reply) {
+        if (data) env->DeleteLocalRef(data);
         if (reply) env->DeleteLocalRef(reply);
-        return false;
+        return -1;
     }
 
-    // Enforce descriptor (Sui: data.enforceInterface(DESCRIPTOR))
-    jstring ams_desc = env->NewStringUTF(AMS_DESCRIPTOR);
-    env->CallVoidMethod(data, g_mid_Parcel_enforceInterface, ams_desc);
-    env->DeleteLocalRef(ams_desc);
+    jstring desc = env->NewStringUTF(MURASAKI_AIDL_DESCRIPTOR);
+    env->CallVoidMethod(data, g_mid_Parcel_writeInterfaceToken, desc);
+    env->DeleteLocalRef(desc);
+
+    jint version = 0;
+    jboolean ok = env->CallBooleanMethod(murasaki_binder, g_mid_IBinder_transact,
+                                         MURASAKI_TX_getInterfaceVersion, data, reply, 0);
     if (env->ExceptionCheck()) {
+        // DeadObjectException and friends; an unknown code just returns false
         clear_exc(env);
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
-        return false;
+        version = -1;
+    } else if (ok) {
+        env->CallVoidMethod(reply, g_mid_Parcel_readException);
+        if (env->ExceptionCheck()) {
+            clear_exc(env);
+        } else {
+            version = env->CallIntMethod(reply, g_mid_Parcel_readInt);
+            if (env->ExceptionCheck()) {
+                clear_exc(env);
+                version = 0;
+            }
+        }
     }
 
-    jint action = env->CallIntMethod(data, g_mid_Parcel_readInt);
-    if (env->ExceptionCheck()) {
-        clear_exc(env);
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
-        return false;
+    env->CallVoidMethod(data, g_mid_Parcel_recycle);
+    env->CallVoidMethod(reply, g_mid_Parcel_recycle);
+    env->DeleteLocalRef(data);
+    env->DeleteLocalRef(reply);
+    return version;
+}
+
+static bool murasaki_supports_bulk(JNIEnv* env, jobject murasaki_binder) {
+    if (!g_mid_Parcel_writeIntArray || !g_mid_Parcel_createIntArray) return false;
+    {
+        std::lock_guard<std::mutex> lock(g_bulk_cap_lock);
+        if (g_bulk_cap_binder && env->IsSameObject(g_bulk_cap_binder, murasaki_binder)) {
+            return g_bulk_cap_supported;
+        }
+    }
+    jint version = murasaki_interface_version(env, murasaki_binder);
+    if (version < 0) return false;  // not remembered: asked again with the next binder
+    bool supported = version >= kBulkGrantMinInterfaceVersion;
+    {
+        std::lock_guard<std::mutex> lock(g_bulk_cap_lock);
+        if (g_bulk_cap_binder) env->DeleteGlobalRef(g_bulk_cap_binder);
+        g_bulk_cap_binder = env->NewGlobalRef(murasaki_binder);
+        g_bulk_cap_supported = supported;
     }
+    logd("murasaki daemon interface version %d, bulk grant query %s", version, supported ? "on" : "off");
+    return supported;
+}
 
-    jint callingUid = env->CallStaticIntMethod(g_cls_Binder, g_mid_getCallingUid);
-    (void) env->CallStaticIntMethod(g_cls_Binder, g_mid_getCallingPid);
-    if (env->ExceptionCheck()) {
+// IMurasakiService.getUidsGrantedRoot: every uid in one transact. False when the call failed,
+// leaving `granted` untouched.
+static bool murasaki_query_uids_bulk(JNIEnv* env, jobject murasaki_binder, const jint* uids, size_t count,
+                                     bool* granted) {
+    jintArray juids = env->NewIntArray(static_cast<jsize>(count));
+    if (!juids) {
         clear_exc(env);
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
         return false;
     }
+    env->SetIntArrayRegion(juids, 0, static_cast<jsize>(count), uids);
 
-    // Fail closed unless declared (Sui: isDeclaredClient)
-    if (!is_declared_client(env, callingUid)) {
-        logd("bridge denied: uid=%d not declared", callingUid);
-        env->DeleteLocalRef(data);
+    jobject data = parcel_obtain(env);
+    jobject reply = parcel_obtain(env);
+    if (!data || !reply) {
+        if (data) env->DeleteLocalRef(data);
         if (reply) env->DeleteLocalRef(reply);
+        env->DeleteLocalRef(juids);
         return false;
     }
 
-    // Rei: if allowlist file exists and uid not in it, show Rei auth dialog instead of denying
-    if (!allowlist_file_contains_uid(callingUid)) {
-        std::string pkg = get_first_package_for_uid(env, callingUid);
-        if (!pkg.empty()) {
-            launch_rei_murasaki_auth(env, callingUid, pkg);
+    jstring desc = env->NewStringUTF(MURASAKI_AIDL_DESCRIPTOR);
+    env->CallVoidMethod(data, g_mid_Parcel_writeInterfaceToken, desc);
+    env->DeleteLocalRef(desc);
+    env->CallVoidMethod(data, g_mid_Parcel_writeIntArray, juids);
+    env->DeleteLocalRef(juids);
+
+    jboolean ok = env->CallBooleanMethod(murasaki_binder, g_mid_IBinder_transact,
+                                         MURASAKI_TX_getUidsGrantedRoot, data, reply, 0);
+    if (env->ExceptionCheck()) {
+        clear_exc(env);
+        ok = JNI_FALSE;
+    }
+
+    bool answered = false;
+    if (ok) {
+        env->CallVoidMethod(reply, g_mid_Parcel_readException);
+        if (env->ExceptionCheck()) {
+            clear_exc(env);
         } else {
-            logd("bridge: uid=%d not in allowlist, no package name to show dialog", callingUid);
+            auto bitmap = (jintArray) env->CallObjectMethod(reply, g_mid_Parcel_createIntArray);
+            if (env->ExceptionCheck()) {
+                clear_exc(env);
+            } else if (bitmap) {
+                size_t words = (count + 31) / 32;
+                if (static_cast<size_t>(env->GetArrayLength(bitmap)) >= words) {
+                    std::vector<jint> bits(words);
+                    env->GetIntArrayRegion(bitmap, 0, static_cast<jsize>(words), bits.data());
+                    for (size_t i = 0; i < count; ++i) {
+                        granted[i] = (static_cast<uint32_t>(bits[i / 32]) >> (i % 32)) & 1u;
+                    }
+                    answered = true;
+                }
+            }
+            if (bitmap) env->DeleteLocalRef(bitmap);
         }
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
-        return false;
     }
 
+    env->CallVoidMethod(data, g_mid_Parcel_recycle);
+    env->CallVoidMethod(reply, g_mid_Parcel_recycle);
+    env->DeleteLocalRef(data);
+    env->DeleteLocalRef(reply);
+    return answered;
+}
+
+// Daemon grant of each uid: one bulk round trip, or one transact per uid for older daemons.
+static void murasaki_query_uids(JNIEnv* env, jobject murasaki_binder, const jint* uids, size_t count,
+                                bool* granted) {
+    if (count == 0) return;
+    if (murasaki_supports_bulk(env, murasaki_binder) &&
+        murasaki_query_uids_bulk(env, murasaki_binder, uids, count, granted)) {
+        return;
+    }
+    logd("bulk grant query unavailable, asking the daemon about %zu uids one by one", count);
+    for (size_t i = 0; i < count; ++i) {
+        // Fail closed: a failed call counts as not granted
+        granted[i] = murasaki_is_uid_allowed(env, murasaki_binder, uids[i]) == DaemonAnswer::Granted;
+    }
+}
+
+static jobject get_murasaki_binder_with_retry(JNIEnv* env, const BridgeConfig& cfg, int attempts) {
     // Daemon may start after system_server; retry like Sui readiness
+    // ...unless the watchdog already knows it is down and is relaunching it: then fail fast
+    if (daemonKnownDown()) attempts = 1;
     jobject murasaki = nullptr;
-    static const int kMaxAttempts = 5;
-    static const useconds_t kDelayUs = 300000;  // 300ms
-    for (int attempt = 0; attempt < kMaxAttempts && !murasaki; ++attempt) {
+    for (int attempt = 0; attempt < attempts && !murasaki; ++attempt) {
         if (attempt > 0)
-            usleep(kDelayUs);
-        murasaki = sm_get_service(env, SERVICE_MURASAKI);
+            usleep(cfg.daemon_retry_delay_ms * 1000);
+        murasaki = resolve_action_binder(env, kMurasakiSlot);
     }
-    if (!murasaki) {
-        logw("murasaki binder not in ServiceManager (reid/apd services not ready?)");
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
+    return murasaki;
+}
+
+// State shared by the stages of one MRSK request.
+struct AuthContext {
+    ConfigRef cfg;  // the request's only configCurrent() snapshot, kept alive until it ends
+    jint uid = -1;
+    uint32_t required = kAllAuthStages;  // stages demanded by the action
+    jobject murasaki = nullptr;  // local ref, resolved by the DaemonGrant stage
+    uint32_t passed = 0;         // bitmask of stages that passed
+    bool daemon_unreachable = false;  // DaemonGrant denied because the daemon is not up or the call failed
+    // Binder lookups DaemonGrant may make (daemon_retry_delay_ms apart). One at first: the retry
+    // budget is only spent once every other stage has passed
+    int daemon_attempts = 1;
+    uint32_t retry_after_ms = 0;      // hint for v2 replies
+};
+
+static inline uint32_t stage_bit(AuthStage stage) {
+    return 1u << static_cast<uint32_t>(stage);
+}
+
+// Trace slice names, indexed by AuthStage
+static constexpr const char* kStageTraceNames[kAuthStageCount] = {
+    "MRSK:auth:ratelimit",
+    "MRSK:auth:allowlist",
+    "MRSK:auth:daemon",
+    "MRSK:auth:declared",
+};
+
+static AuthVerdict run_auth_stage(JNIEnv* env, AuthStage stage, AuthContext& ctx) {
+    switch (stage) {
+        case AuthStage::RateLimit: {
+            uint64_t retry_after_ns = 0;
+            if (!rateLimitAllow(ctx.uid, ctx.cfg->rate_limit_per_window, ctx.cfg->rate_limit_window_ms * 1000000ull,
+                                &retry_after_ns)) {
+                logw("bridge denied: uid=%d rate limited", ctx.uid);
+                ctx.retry_after_ms = static_cast<uint32_t>((retry_after_ns + 999999) / 1000000);
+                return AuthVerdict::Deny;
+            }
+            return AuthVerdict::Pass;
+        }
+        case AuthStage::Allowlist:
+            return allowlist_file_contains_uid(*ctx.cfg, ctx.uid) ? AuthVerdict::Pass : AuthVerdict::Deny;
+        case AuthStage::DaemonGrant:
+            if (!ctx.murasaki) {
+                ctx.murasaki = get_murasaki_binder_with_retry(env, *ctx.cfg, ctx.daemon_attempts);
+            }
+            if (!ctx.murasaki) {
+                logw("murasaki binder not in ServiceManager (reid/apd services not ready?)");
+                ctx.daemon_unreachable = true;
+                ctx.retry_after_ms = kNotReadyRetryAfterMs;
+                return AuthVerdict::Deny;
+            }
+            // Rei: daemon allowlist check (isUidGrantedRoot)
+            switch (murasaki_is_uid_allowed(env, ctx.murasaki, ctx.uid)) {
+                case DaemonAnswer::Granted:
+                    return AuthVerdict::Pass;
+                case DaemonAnswer::Denied:
+                    logd("bridge denied: uid=%d not granted by daemon", ctx.uid);
+                    return AuthVerdict::Deny;
+                case DaemonAnswer::CallFailed:
+                    // Daemon died under us: forget its binder so the client's retry resolves the new one
+                    logw("bridge: isUidGrantedRoot failed for uid=%d, daemon binder dropped", ctx.uid);
+                    drop_action_binder(env, kMurasakiSlot, ctx.murasaki);
+                    env->DeleteLocalRef(ctx.murasaki);
+                    ctx.murasaki = nullptr;
+                    ctx.daemon_unreachable = true;
+                    ctx.retry_after_ms = kNotReadyRetryAfterMs;
+                    return AuthVerdict::Deny;
+            }
+            return AuthVerdict::Deny;
+        case AuthStage::Declared:
+            // Fail closed unless declared (Sui: isDeclaredClient)
+            if (!is_declared_client(env, ctx.uid)) {
+                logd("bridge denied: uid=%d not declared", ctx.uid);
+                return AuthVerdict::Deny;
+            }
+            return AuthVerdict::Pass;
+    }
+    return AuthVerdict::Deny;
+}
+
+// Runs one stage with timing and tracing; marks it passed.
+static AuthVerdict run_timed_stage(JNIEnv* env, AuthStage stage, AuthContext& ctx) {
+    ScopedTrace trace(kStageTraceNames[static_cast<size_t>(stage)]);
+    uint64_t t0 = monotonicNs();
+    AuthVerdict v = run_auth_stage(env, stage, ctx);
+    recordAuthStage(stage, monotonicNs() - t0, v == AuthVerdict::Deny);
+    if (v == AuthVerdict::Pass) {
+        ctx.passed |= stage_bit(stage);
+    }
+    return v;
+}
+
+// DaemonGrant on a JVM helper thread, on its own copy of the request context (holding the config
+// snapshot): the binder thread stops waiting as soon as Declared denies, and whichever side is
+// done last frees the job. Local refs die with the helper's frame, so the resolved binder comes
+// back as a global ref.
+struct DaemonGrantJob {
+    JvmTask task;
+    AuthContext ctx;
+    AuthVerdict verdict = AuthVerdict::Deny;  // fail closed
+    jobject murasaki = nullptr;  // global ref
+    std::atomic<int> refs{2};    // binder thread + helper
+};
+
+static void unref_daemon_grant_job(JNIEnv* env, DaemonGrantJob* job) {
+    if (job->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    if (job->murasaki) env->DeleteGlobalRef(job->murasaki);
+    delete job;
+}
+
+static void release_daemon_grant_job(JNIEnv* env, JvmTask* task) {
+    unref_daemon_grant_job(env, static_cast<DaemonGrantJob*>(task->arg));
+}
+
+static void daemon_grant_job(JNIEnv* env, void* arg) {
+    auto* job = static_cast<DaemonGrantJob*>(arg);
+    job->verdict = run_timed_stage(env, AuthStage::DaemonGrant, job->ctx);
+    if (job->ctx.murasaki) {
+        job->murasaki = env->NewGlobalRef(job->ctx.murasaki);
+        job->ctx.murasaki = nullptr;
+    }
+}
+
+// DaemonGrant (one daemon transact) and Declared (several PackageManager round trips) are
+// independent: with the daemon ordered first, its query goes to a helper while this thread checks
+// the manifest, so a granted request waits for the slower of the two instead of both. A Declared
+// denial returns at once and leaves the helper to finish alone. Returns false, having run
+// nothing, when no helper is idle; otherwise *verdict covers both stages and *denied_by the
+// denying one (Declared when it denied).
+static bool overlap_grant_and_declared(JNIEnv* env, AuthContext& ctx, AuthVerdict* verdict, AuthStage* denied_by) {
+    auto* job = new DaemonGrantJob();
+    job->ctx.cfg = ctx.cfg;
+    job->ctx.uid = ctx.uid;
+    job->ctx.required = ctx.required;
+    job->ctx.daemon_attempts = ctx.cfg->daemon_max_attempts;  // waited for only if Declared passes
+    job->task.fn = daemon_grant_job;
+    job->task.arg = job;
+    job->task.release = release_daemon_grant_job;
+    if (!jvmWorkerTrySubmit(env, &job->task)) {
+        delete job;
         return false;
     }
 
-    // Rei: daemon allowlist check (isUidGrantedRoot). If call fails, still pass binder (Sui doesn't check)
-    bool uidAllowed = murasaki_is_uid_allowed(env, murasaki, callingUid);
-    if (!uidAllowed) {
-        env->DeleteLocalRef(murasaki);
-        logd("bridge denied: uid=%d not granted by daemon", callingUid);
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
+    if (run_timed_stage(env, AuthStage::Declared, ctx) == AuthVerdict::Deny) {
+        unref_daemon_grant_job(env, job);
+        *verdict = AuthVerdict::Deny;
+        *denied_by = AuthStage::Declared;
+        return true;
+    }
+    job->task.wait();
+    if (job->murasaki) {
+        ctx.murasaki = env->NewLocalRef(job->murasaki);
+        env->DeleteGlobalRef(job->murasaki);
+        job->murasaki = nullptr;
+    }
+    *verdict = job->verdict;
+    ctx.daemon_unreachable = job->ctx.daemon_unreachable;
+    ctx.daemon_attempts = job->ctx.daemon_attempts;
+    ctx.retry_after_ms = job->ctx.retry_after_ms;
+    unref_daemon_grant_job(env, job);
+    if (*verdict == AuthVerdict::Deny) {
+        *denied_by = AuthStage::DaemonGrant;
+    } else {
+        ctx.passed |= stage_bit(AuthStage::DaemonGrant);
+    }
+    return true;
+}
+
+// Runs every stage in `order` and short-circuits on the first denial (reported via denied_by).
+// A daemon that cannot be reached is only a transient answer: the remaining stages still run, so
+// a caller they reject gets that definitive denial instead of a not-ready retry loop, without
+// first sleeping through the daemon retry budget. Only a caller every other stage admits waits
+// for a daemon that is still starting.
+static bool run_auth_pipeline(JNIEnv* env, const AuthOrder& order, AuthContext& ctx, AuthStage* denied_by) {
+    uint32_t pending = ctx.required;
+    bool not_ready = false;
+    uint32_t not_ready_retry_ms = 0;
+    for (size_t i = 0; i < kAuthStageCount; ++i) {
+        AuthStage stage = order.stages[i];
+        if (!(pending & stage_bit(stage))) continue;
+        pending &= ~stage_bit(stage);
+
+        // Next stage that will actually run. Daemon then Declared overlap; Declared then daemon stay
+        // in order, so a Declared denial costs no daemon call. While the watchdog has the daemon
+        // down the stage fails fast inline, and there is nothing to overlap.
+        size_t j = i + 1;
+        while (j < kAuthStageCount && !(pending & stage_bit(order.stages[j]))) ++j;
+        bool overlap = stage == AuthStage::DaemonGrant && j < kAuthStageCount &&
+                       order.stages[j] == AuthStage::Declared && !daemonKnownDown();
+
+        AuthVerdict verdict;
+        AuthStage denied = stage;
+        if (overlap && overlap_grant_and_declared(env, ctx, &verdict, &denied)) {
+            pending &= ~stage_bit(AuthStage::Declared);
+        } else {
+            verdict = run_timed_stage(env, stage, ctx);
+        }
+        if (verdict == AuthVerdict::Pass) continue;
+
+        if (denied == AuthStage::DaemonGrant && ctx.daemon_unreachable) {
+            not_ready = true;
+            not_ready_retry_ms = ctx.retry_after_ms;
+            ctx.retry_after_ms = 0;
+            continue;
+        }
+        ctx.daemon_unreachable = false;
+        *denied_by = denied;
         return false;
     }
+    if (!not_ready) return true;
+    if (ctx.daemon_attempts < ctx.cfg->daemon_max_attempts && !daemonKnownDown()) {
+        // Every other stage passed: now worth waiting for a daemon that is still starting
+        ctx.daemon_unreachable = false;
+        ctx.daemon_attempts = ctx.cfg->daemon_max_attempts;
+        if (run_timed_stage(env, AuthStage::DaemonGrant, ctx) == AuthVerdict::Pass) return true;
+    } else {
+        ctx.retry_after_ms = not_ready_retry_ms;
+    }
+    *denied_by = AuthStage::DaemonGrant;
+    return false;
+}
+
+static AuditVerdict denied_verdict(AuthStage stage) {
+    switch (stage) {
+        case AuthStage::RateLimit:
+            return AuditVerdict::DeniedRateLimit;
+        case AuthStage::Allowlist:
+            return AuditVerdict::DeniedAllowlist;
+        case AuthStage::DaemonGrant:
+            return AuditVerdict::DeniedDaemon;
+        case AuthStage::Declared:
+            return AuditVerdict::DeniedDeclared;
+    }
+    return AuditVerdict::DeniedDeclared;
+}
+
+static jint denied_status(AuthStage stage, const AuthContext& ctx) {
+    switch (stage) {
+        case AuthStage::RateLimit:
+            return MRSK_STATUS_RATE_LIMITED;
+        case AuthStage::Allowlist:
+            return MRSK_STATUS_DENIED_POLICY;
+        case AuthStage::DaemonGrant:
+            return ctx.daemon_unreachable ? MRSK_STATUS_NOT_READY : MRSK_STATUS_DENIED_POLICY;
+        case AuthStage::Declared:
+            return MRSK_STATUS_DENIED_UNDECLARED;
+    }
+    return MRSK_STATUS_DENIED_POLICY;
+}
+
+// Protocol version the client asked for: v1 clients write nothing after the action.
+static jint read_protocol_version(JNIEnv* env, jobject data) {
+    jint avail = env->CallIntMethod(data, g_mid_Parcel_dataAvail);
+    if (env->ExceptionCheck() || avail < static_cast<jint>(sizeof(jint))) {
+        clear_exc(env);
+        return MRSK_PROTOCOL_LEGACY;
+    }
+    jint version = env->CallIntMethod(data, g_mid_Parcel_readInt);
+    if (env->ExceptionCheck() || version < MRSK_PROTOCOL_STATUS) {
+        clear_exc(env);
+        return MRSK_PROTOCOL_LEGACY;
+    }
+    // Newer clients get the newest reply we speak; the reply carries the version
+    return MRSK_PROTOCOL_STATUS;
+}
 
-    jobject out_binder = nullptr;
-    if (action == ACTION_GET_MURASAKI_BINDER) {
-        out_binder = murasaki;  // already a local ref
-    } else if (action == ACTION_GET_SHIZUKU_BINDER) {
-        jobject shizuku = sm_get_service(env, SERVICE_SHIZUKU);
-        if (!shizuku) {
-            shizuku = sm_get_service(env, SERVICE_SHIZUKU_FALLBACK);
+static void write_status_reply(JNIEnv* env, jobject reply, jint status, uint32_t retry_after_ms, jobject binder) {
+    if (!reply) return;
+    env->CallVoidMethod(reply, g_mid_Parcel_writeNoException);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, MRSK_PROTOCOL_STATUS);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, status);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, static_cast<jint>(retry_after_ms));
+    env->CallVoidMethod(reply, g_mid_Parcel_writeStrongBinder, binder);
+    clear_exc(env);
+}
+
+// ACTION_GET_STATUS reply: noException, version, bridge versionCode, daemon state (0 unknown,
+// 1 up, 2 down), caller has a cached grant (0/1), ms left on that grant. No PackageManager or
+// daemon IPC, no config or property read, no sleeping: health-check polling costs a few atomic
+// loads and one session-cache lookup.
+static void write_bridge_status(JNIEnv* env, jobject reply, jint uid, jint pid) {
+    if (!reply) return;
+    uint32_t remaining_ms = 0;
+    bool cached = sessionCachePeek(pid, uid, kAllAuthStages, &remaining_ms);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeNoException);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, MRSK_PROTOCOL_STATUS);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, static_cast<jint>(MURASAKI_BRIDGE_VERSION_CODE));
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, static_cast<jint>(daemonState()));
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, cached ? 1 : 0);
+    env->CallVoidMethod(reply, g_mid_Parcel_writeInt, static_cast<jint>(remaining_ms));
+    clear_exc(env);
+}
+
+static void audit(jint uid, jint pid, jint action, AuditVerdict verdict, uint64_t start_ns) {
+    AuditRecord r;
+    r.time_ms = realtimeMs();
+    r.uid = uid;
+    r.pid = pid;
+    r.action = action;
+    r.latency_us = static_cast<uint32_t>((monotonicNs() - start_ns) / 1000);
+    r.verdict = verdict;
+    auditLogSubmit(r);
+}
+
+// MRSK body behind the execTransact hook. data/reply stay owned by the caller; reply may be null.
+// Returns whether the transaction was consumed: granted, or any answered v2 request.
+static bool handle_bridge_parcels(JNIEnv* env, jobject data, jobject reply) {
+    ScopedTrace trace_request("MRSK");
+    uint64_t start_ns = monotonicNs();
+
+    jint action;
+    size_t action_idx;
+    jint version;
+    jint callingUid;
+    jint callingPid;
+    {
+        ScopedTrace trace("MRSK:parse");
+        // Enforce descriptor (Sui: data.enforceInterface(DESCRIPTOR))
+        jstring ams_desc = env->NewStringUTF(AMS_DESCRIPTOR);
+        env->CallVoidMethod(data, g_mid_Parcel_enforceInterface, ams_desc);
+        env->DeleteLocalRef(ams_desc);
+        if (env->ExceptionCheck()) {
+            clear_exc(env);
+            return false;
         }
-        out_binder = shizuku;  // may be null
-        env->DeleteLocalRef(murasaki);
+
+        action = env->CallIntMethod(data, g_mid_Parcel_readInt);
+        if (env->ExceptionCheck()) {
+            clear_exc(env);
+            return false;
+        }
+        // Unknown actions are rejected before any authorization work
+        action_idx = action_index(action);
+        if (action_idx == kActionCount && action != ACTION_GET_STATUS) {
+            return false;
+        }
+        version = read_protocol_version(env, data);
+
+        callingUid = env->CallStaticIntMethod(g_cls_Binder, g_mid_getCallingUid);
+        callingPid = env->CallStaticIntMethod(g_cls_Binder, g_mid_getCallingPid);
+        if (env->ExceptionCheck()) {
+            clear_exc(env);
+            return false;
+        }
+    }
+
+    if (action == ACTION_GET_STATUS) {
+        ScopedTrace trace("MRSK:status");
+        write_bridge_status(env, reply, callingUid, callingPid);
+        return true;
+    }
+
+    // Not for status queries, which read only in-memory state: the atrace property and the config
+    // file are checked here, and one config snapshot serves every stage and cache call below
+    traceRefresh();
+    ConfigRef cfg = configCurrent();
+
+    static std::atomic<uint32_t> s_requests{0};
+    if ((s_requests.fetch_add(1, std::memory_order_relaxed) & (kAuthStatsLogInterval - 1)) == 0) {
+        logAuthStats();
+        log_action_stats();
+        logSessionCacheStats();
+        logDaemonHealth();
+    }
+
+    AuthContext ctx;
+    ctx.cfg = cfg;
+    ctx.uid = callingUid;
+    ctx.required = kActionTable[action_idx].required_stages;
+    AuthStage denied_by = AuthStage::Declared;
+    // Same live process authorized recently (reconnect after binder death, several client instances)
+    bool cached;
+    {
+        ScopedTrace trace("MRSK:sessionLookup");
+        cached = sessionCacheLookup(*cfg, callingPid, callingUid, ctx.required);
+    }
+    if (!cached && !run_auth_pipeline(env, cfg->auth_order, ctx, &denied_by)) {
+        // Rei: if allowlist file exists and uid not in it, show Rei auth dialog instead of denying.
+        // Only declared clients may raise the dialog, so confirm that first if it has not run yet.
+        if (denied_by == AuthStage::Allowlist &&
+            ((ctx.passed & stage_bit(AuthStage::Declared)) || is_declared_client(env, callingUid))) {
+            ScopedTrace trace("MRSK:authDialog");
+            std::string pkg = get_first_package_for_uid(env, callingUid);
+            if (!pkg.empty()) {
+                launch_rei_murasaki_auth(env, callingUid, pkg);
+                ctx.retry_after_ms = kAuthDialogRetryAfterMs;
+            } else {
+                logd("bridge: uid=%d not in allowlist, no package name to show dialog", callingUid);
+            }
+        }
+        if (ctx.murasaki) env->DeleteLocalRef(ctx.murasaki);
+        audit(callingUid, callingPid, action, denied_verdict(denied_by), start_ns);
+        if (version < MRSK_PROTOCOL_STATUS) {
+            return false;
+        }
+        write_status_reply(env, reply, denied_status(denied_by, ctx), ctx.retry_after_ms, nullptr);
+        return true;
+    }
+    if (!cached) {
+        ScopedTrace trace("MRSK:sessionStore");
+        sessionCacheStore(*cfg, callingPid, callingUid, ctx.passed);
+    }
+
+    jobject out_binder = nullptr;  // may be null
+    if (action_idx == kMurasakiSlot && ctx.murasaki) {
+        out_binder = ctx.murasaki;  // already a local ref
     } else {
-        env->DeleteLocalRef(murasaki);
-        env->DeleteLocalRef(data);
-        if (reply) env->DeleteLocalRef(reply);
-        return false;
+        ScopedTrace trace("MRSK:resolveBinder");
+        out_binder = resolve_action_binder(env, action_idx);
+        if (ctx.murasaki) env->DeleteLocalRef(ctx.murasaki);
     }
 
-    if (reply) {
+    if (version >= MRSK_PROTOCOL_STATUS) {
+        ScopedTrace trace("MRSK:reply");
+        // Authorized, but the target service is not registered (yet)
+        if (out_binder) {
+            write_status_reply(env, reply, MRSK_STATUS_GRANTED, 0, out_binder);
+        } else {
+            write_status_reply(env, reply, MRSK_STATUS_NOT_READY, kNotReadyRetryAfterMs, nullptr);
+        }
+    } else if (reply) {
+        ScopedTrace trace("MRSK:reply");
         env->CallVoidMethod(reply, g_mid_Parcel_writeNoException);
         env->CallVoidMethod(reply, g_mid_Parcel_writeStrongBinder, out_binder);
         clear_exc(env);
     }
 
-    env->DeleteLocalRef(data);
-    if (reply) env->DeleteLocalRef(reply);
-    if (out_binder)
-        env->DeleteLocalRef(out_binder);
+    if (!out_binder) {
+        audit(callingUid, callingPid, action, AuditVerdict::ServiceMissing, start_ns);
+        logd("bridge: uid=%d pid=%d action=%d authorized, service not registered", callingUid, callingPid, action);
+        return true;
+    }
+    env->DeleteLocalRef(out_binder);
 
-    logd("bridge ok: uid=%d action=%d", callingUid, action);
+    audit(callingUid, callingPid, action, cached ? AuditVerdict::GrantedSession : AuditVerdict::Granted, start_ns);
+    logd("bridge ok: uid=%d pid=%d action=%d%s", callingUid, callingPid, action, cached ? " (session)" : "");
     return true;
 }
 
+static bool handle_bridge(JNIEnv* env, jint code, jlong dataObj, jlong replyObj) {
+    if (code != TRANSACTION_MRSK) {
+        return false;
+    }
+    if (!ensure_jni(env, JniGroup::Core)) {
+        return false;
+    }
+
+    jobject data = parcel_from_ptr(env, dataObj);
+    jobject reply = parcel_from_ptr(env, replyObj);
+    if (!data) {
+        if (reply) env->DeleteLocalRef(reply);
+        return false;
+    }
+    bool consumed = handle_bridge_parcels(env, data, reply);
+    env->DeleteLocalRef(data);
+    if (reply) env->DeleteLocalRef(reply);
+    return consumed;
+}
+
 void startReidDaemonIfNeeded() {
+    traceRefresh();
+    // Only the parent leaves this scope; the forked children _exit/exec without running destructors
+    ScopedTrace trace("reid:start");
     // Double-fork: 子进程再 fork，孙进程 exec 后由 init 接管，避免僵尸进程
     pid_t pid = fork();
     if (pid < 0) {
@@ -675,6 +1435,7 @@ void startReidDaemonIfNeeded() {
         return;
     }
     if (pid > 0) {
+        ScopedTrace trace_wait("reid:waitpid");
         (void)waitpid(pid, nullptr, 0);
         return;
     }
@@ -692,6 +1453,64 @@ void startReidDaemonIfNeeded() {
     _exit(127);
 }
 
+// Watchdog probe: the cached Murasaki binder, pinged. A binder that stopped answering is dropped
+// from the slot and resolved again, so the next client request finds a fresh one.
+static jobject probe_murasaki_binder(JNIEnv* env) {
+    if (!ensure_jni(env, JniGroup::Core)) {
+        return nullptr;
+    }
+    jobject b = resolve_action_binder(env, kMurasakiSlot);
+    if (!b) return nullptr;
+    jboolean ok = env->CallBooleanMethod(b, g_mid_IBinder_pingBinder);
+    if (env->ExceptionCheck()) {
+        clear_exc(env);
+        ok = JNI_FALSE;
+    }
+    if (ok) return b;
+    drop_action_binder(env, kMurasakiSlot, b);
+    env->DeleteLocalRef(b);
+    return resolve_action_binder(env, kMurasakiSlot);
+}
+
+// Watchdog hook once the daemon is back: its policy may have changed while it was down, so the
+// uids holding cached sessions are re-checked in one round trip and revoked ones lose them.
+static void refresh_session_grants(JNIEnv* env, jobject murasaki) {
+    jint uids[kMaxSessionSlots];
+    size_t n = sessionCacheUids(uids, kMaxSessionSlots);
+    if (n == 0) return;
+    ScopedTrace trace("watchdog:refresh");
+    bool granted[kMaxSessionSlots];
+    murasaki_query_uids(env, murasaki, uids, n, granted);
+    size_t revoked = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!granted[i]) {
+            sessionCacheEvictUid(uids[i]);
+            ++revoked;
+        }
+    }
+    logd("daemon grants refreshed: uids=%zu revoked=%zu", n, revoked);
+}
+
+void startDaemonWatchdog(JNIEnv* env) {
+    JavaVM* vm = nullptr;
+    if (env->GetJavaVM(&vm) != JNI_OK || !vm) {
+        logw("startDaemonWatchdog: GetJavaVM failed");
+        return;
+    }
+    daemonWatchdogStart(vm, probe_murasaki_binder, startReidDaemonIfNeeded, refresh_session_grants,
+                        sessionCacheSweep);
+}
+
+bool queryDaemonGrants(JNIEnv* env, const jint* uids, size_t count, bool* granted) {
+    if (!ensure_jni(env, JniGroup::Core)) return false;
+    ConfigRef cfg = configCurrent();
+    jobject murasaki = get_murasaki_binder_with_retry(env, *cfg, cfg->daemon_max_attempts);
+    if (!murasaki) return false;
+    murasaki_query_uids(env, murasaki, uids, count, granted);
+    env->DeleteLocalRef(murasaki);
+    return true;
+}
+
 void setOriginalExecTransact(ExecTransact_t orig) {
     g_orig_execTransact = orig;
 }
@@ -2,6 +2,8 @@
 
 #include <jni.h>
 
+#include <cstddef>
+
 namespace murasaki::bridge {
 
 using ExecTransact_t = jboolean (*)(JNIEnv*, jobject, jint, jlong, jlong, jint);
@@ -16,5 +18,12 @@ void setOriginalExecTransact(ExecTransact_t orig);
 // 在 system_server 启动时触发 reid/apd/ksud services，拉起 Murasaki daemon（供 Zygisk 桥接注入 Binder）
 void startReidDaemonIfNeeded();
 
+// Starts the daemon watchdog thread (relaunches the daemon and keeps its binder resolved).
+void startDaemonWatchdog(JNIEnv* env);
+
+// Daemon grant of every uid (granted[i] answers uids[i]) in a single bulk transaction, or one
+// transaction per uid when the daemon lacks the bulk call. False if the daemon is unreachable.
+bool queryDaemonGrants(JNIEnv* env, const jint* uids, size_t count, bool* granted);
+
 }  // namespace murasaki::bridge
 
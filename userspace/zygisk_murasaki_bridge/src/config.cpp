@@ -0,0 +1,154 @@
+#include "config.hpp"
+
+#include <sys/stat.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include "log.hpp"
+
+namespace murasaki::bridge {
+
+static constexpr uint64_t kConfigCheckIntervalNs = 1000000000ull;  // 1s
+static constexpr size_t kMaxConfigBytes = 8192;
+
+// Limits keep the worst case retry wait (attempts * delay) at 20s.
+static constexpr int kMaxDaemonAttempts = 20;
+static constexpr uint32_t kMaxDaemonRetryDelayMs = 1000;
+
+// Never destroyed: detached helper threads may still read it while the process exits.
+// Accessed only through std::atomic_load / std::atomic_store.
+static ConfigRef* const g_config = new ConfigRef(std::make_shared<const BridgeConfig>());
+static std::atomic<uint64_t> g_next_check_ns{0};
+
+static std::mutex g_reload_mutex;  // reloader only
+static struct stat g_file_stat;
+static bool g_file_seen = false;
+static uint64_t g_generation = 0;
+
+static char* trim(char* s) {
+    while (*s == ' ' || *s == '\t') ++s;
+    char* end = s + strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) --end;
+    *end = '\0';
+    return s;
+}
+
+static bool parse_long(const char* key, const char* value, long lo, long hi, long* out) {
+    char* end = nullptr;
+    long v = strtol(value, &end, 10);
+    if (end == value || *end != '\0') {
+        logw("config: %s=%s is not a number", key, value);
+        return false;
+    }
+    *out = v < lo ? lo : (v > hi ? hi : v);
+    return true;
+}
+
+BridgeConfig parseConfig(const char* text) {
+    BridgeConfig cfg;
+    std::string copy(text ? text : "");
+    char* save = nullptr;
+    for (char* line = strtok_r(&copy[0], "\n", &save); line; line = strtok_r(nullptr, "\n", &save)) {
+        char* l = trim(line);
+        if (*l == '\0' || *l == '#') continue;
+        char* eq = strchr(l, '=');
+        if (!eq) {
+            logw("config: ignoring line '%s'", l);
+            continue;
+        }
+        *eq = '\0';
+        const char* key = trim(l);
+        const char* value = trim(eq + 1);
+        long v = 0;
+
+        if (strcmp(key, "daemon_max_attempts") == 0) {
+            if (parse_long(key, value, 1, kMaxDaemonAttempts, &v)) cfg.daemon_max_attempts = static_cast<int>(v);
+        } else if (strcmp(key, "daemon_retry_delay_ms") == 0) {
+            if (parse_long(key, value, 0, kMaxDaemonRetryDelayMs, &v)) cfg.daemon_retry_delay_ms = static_cast<uint32_t>(v);
+        } else if (strcmp(key, "allowlist") == 0) {
+            cfg.allowlist_paths.clear();
+            std::string paths(value);
+            char* psave = nullptr;
+            for (char* p = strtok_r(&paths[0], ",", &psave); p; p = strtok_r(nullptr, ",", &psave)) {
+                char* path = trim(p);
+                if (*path) cfg.allowlist_paths.emplace_back(path);
+            }
+        } else if (strcmp(key, "auth_order") == 0) {
+            cfg.auth_order = parseAuthOrder(value);
+        } else if (strcmp(key, "rate_limit") == 0) {
+            if (parse_long(key, value, 1, 10000, &v)) cfg.rate_limit_per_window = static_cast<int>(v);
+        } else if (strcmp(key, "rate_limit_window_ms") == 0) {
+            if (parse_long(key, value, 10, 60000, &v)) cfg.rate_limit_window_ms = static_cast<uint32_t>(v);
+        } else if (strcmp(key, "session_ttl_ms") == 0) {
+            if (parse_long(key, value, 0, 3600000, &v)) cfg.session_ttl_ms = static_cast<uint32_t>(v);
+        } else if (strcmp(key, "session_slots") == 0) {
+            if (parse_long(key, value, 16, kMaxSessionSlots, &v)) cfg.session_slots = static_cast<size_t>(v);
+        } else if (strcmp(key, "log_level") == 0) {
+            if (strcmp(value, "debug") == 0)
+                cfg.log_level = LOG_LEVEL_DEBUG;
+            else if (strcmp(value, "warn") == 0)
+                cfg.log_level = LOG_LEVEL_WARN;
+            else if (strcmp(value, "silent") == 0)
+                cfg.log_level = LOG_LEVEL_SILENT;
+            else
+                logw("config: unknown log_level %s", value);
+        } else {
+            logw("config: unknown key %s", key);
+        }
+    }
+    return cfg;
+}
+
+static bool same_file(const struct stat& a, const struct stat& b) {
+    return a.st_ino == b.st_ino && a.st_size == b.st_size && a.st_mtime == b.st_mtime;
+}
+
+// 旧快照由最后一个持有它的请求释放
+static void publish(BridgeConfig next) {
+    next.generation = ++g_generation;
+    g_log_level.store(next.log_level, std::memory_order_relaxed);
+    std::atomic_store(g_config, ConfigRef(std::make_shared<const BridgeConfig>(std::move(next))));
+}
+
+static void maybe_reload() {
+    std::lock_guard<std::mutex> lock(g_reload_mutex);
+    struct stat st;
+    if (stat(CONFIG_PATH, &st) != 0) {
+        // File removed: fall back to built-in defaults
+        if (g_file_seen) {
+            g_file_seen = false;
+            publish(BridgeConfig());
+            logd("config: %s removed, using defaults", CONFIG_PATH);
+        }
+        return;
+    }
+    if (g_file_seen && same_file(st, g_file_stat)) return;
+
+    FILE* f = fopen(CONFIG_PATH, "re");
+    if (!f) return;
+    std::string text(kMaxConfigBytes, '\0');
+    size_t n = fread(&text[0], 1, kMaxConfigBytes, f);
+    fclose(f);
+    text.resize(n);
+
+    g_file_stat = st;
+    g_file_seen = true;
+    publish(parseConfig(text.c_str()));
+    logd("config: loaded %s (generation %llu)", CONFIG_PATH, (unsigned long long) g_generation);
+}
+
+ConfigRef configCurrent() {
+    uint64_t now = monotonicNs();
+    uint64_t next = g_next_check_ns.load(std::memory_order_relaxed);
+    if (now >= next &&
+        g_next_check_ns.compare_exchange_strong(next, now + kConfigCheckIntervalNs, std::memory_order_relaxed)) {
+        maybe_reload();
+    }
+    return std::atomic_load(g_config);
+}
+
+}  // namespace murasaki::bridge
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "auth_pipeline.hpp"
+
+namespace murasaki::bridge {
+
+// Runtime tunables, read from CONFIG_PATH (key=value lines, '#' comments). Each parse produces an
+// immutable snapshot published as a shared_ptr; a request keeps its snapshot alive for as long as it
+// holds the reference, however long a daemon or PackageManager call blocks it.
+// Every key applies on reload except session_slots.
+
+static constexpr const char* CONFIG_PATH = "/data/system/murasaki_bridge/bridge.conf";
+
+static constexpr size_t kMaxSessionSlots = 1024;
+
+struct BridgeConfig {
+    // Murasaki binder lookup while the daemon is starting
+    int daemon_max_attempts = 5;
+    uint32_t daemon_retry_delay_ms = 300;
+    // Rei 优先，兼容 YukiSU 旧路径
+    std::vector<std::string> allowlist_paths = {
+        "/data/adb/rei/.murasaki_allowlist",
+        "/data/adb/ksu/.murasaki_allowlist",
+    };
+    AuthOrder auth_order = defaultAuthOrder();
+    int rate_limit_per_window = 20;
+    uint32_t rate_limit_window_ms = 1000;
+    uint32_t session_ttl_ms = 10000;
+    size_t session_slots = 256;  // restart-only: the session cache sizes itself once, on first use
+    int log_level = 0;  // LogLevel
+    uint64_t generation = 0;
+};
+
+using ConfigRef = std::shared_ptr<const BridgeConfig>;
+
+// Current snapshot. Checks the file for changes at most once per second (one stat()).
+ConfigRef configCurrent();
+
+// Parse `text` on top of the defaults. Unknown keys and bad values are logged and ignored;
+// numeric values are clamped so a typo cannot stall binder threads.
+BridgeConfig parseConfig(const char* text);
+
+}  // namespace murasaki::bridge
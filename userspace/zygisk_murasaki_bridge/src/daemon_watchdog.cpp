@@ -0,0 +1,244 @@
+#include "daemon_watchdog.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#if defined(__ANDROID__)
+#include <android/binder_ibinder.h>
+#include <android/binder_ibinder_jni.h>
+#endif
+
+#include "auth_pipeline.hpp"
+#include "jvm_worker.hpp"
+#include "log.hpp"
+#include "trace.hpp"
+
+namespace murasaki::bridge {
+
+// 启动时 postServerSpecialize 已拉起 daemon，给它留出注册 binder 的时间再开始探测
+static constexpr uint32_t kStartupGraceMs = 10000;
+static constexpr uint32_t kPingIntervalMs = 5000;
+// While down: re-probe interval, and the relaunch backoff (doubles up to the cap)
+static constexpr uint32_t kDownProbeIntervalMs = 500;
+static constexpr uint32_t kRelaunchBackoffMinMs = 1000;
+static constexpr uint32_t kRelaunchBackoffMaxMs = 60000;
+
+static std::once_flag g_watchdog_once;
+static JavaVM* g_vm = nullptr;
+static DaemonProbe g_probe = nullptr;
+static DaemonLaunch g_launch = nullptr;
+static DaemonRecovered g_recovered = nullptr;
+static WatchdogTick g_tick = nullptr;
+static jobject g_last_binder = nullptr;  // global ref, watchdog thread only
+
+// Never destroyed: the watchdog blocks on the condition variable for the life of the process.
+struct WakeState {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool death_pending = false;
+};
+
+static WakeState* const g_wake = new WakeState();
+
+static std::atomic<bool> g_up{false};
+static std::atomic<bool> g_known_down{false};
+static std::atomic<uint64_t> g_down_since_ns{0};  // valid while g_known_down
+static std::atomic<uint32_t> g_outages{0};
+static std::atomic<uint32_t> g_relaunches{0};
+static std::atomic<uint64_t> g_pings{0};
+static std::atomic<uint64_t> g_ping_failures{0};
+static std::atomic<uint64_t> g_downtime_ns{0};  // finished outages
+static std::atomic<uint64_t> g_last_recovery_ns{0};
+static std::atomic<uint64_t> g_max_recovery_ns{0};
+
+// Sleeps for `ms` or until the daemon binder dies (death notifications are device-only).
+static void wait_for(uint32_t ms) {
+    std::unique_lock<std::mutex> lock(g_wake->mutex);
+    g_wake->cv.wait_for(lock, std::chrono::milliseconds(ms), [] { return g_wake->death_pending; });
+    g_wake->death_pending = false;
+}
+
+#if defined(__ANDROID__)
+
+static AIBinder_DeathRecipient* g_death_recipient = nullptr;
+static AIBinder* g_linked = nullptr;  // watchdog thread only
+
+static void wake_watchdog() {
+    {
+        std::lock_guard<std::mutex> lock(g_wake->mutex);
+        g_wake->death_pending = true;
+    }
+    g_wake->cv.notify_one();
+}
+
+static void on_binder_died(void*) {
+    logw("watchdog: murasaki daemon binder died");
+    wake_watchdog();
+}
+
+// Also makes BinderProxy.isBinderAlive() accurate for the bridge's cached slot, which relies on it.
+static void link_to_death(JNIEnv* env, jobject binder) {
+    AIBinder* ab = AIBinder_fromJavaBinder(env, binder);
+    if (!ab) return;
+    if (ab == g_linked) {
+        AIBinder_decStrong(ab);
+        return;
+    }
+    if (!g_death_recipient) {
+        g_death_recipient = AIBinder_DeathRecipient_new(on_binder_died);
+    }
+    if (AIBinder_linkToDeath(ab, g_death_recipient, nullptr) != STATUS_OK) {
+        logw("watchdog: linkToDeath failed, relying on pings");
+        AIBinder_decStrong(ab);
+        return;
+    }
+    if (g_linked) {
+        (void)AIBinder_unlinkToDeath(g_linked, g_death_recipient, nullptr);
+        AIBinder_decStrong(g_linked);
+    }
+    g_linked = ab;
+}
+
+#else
+
+// Host builds (bench/) have no libbinder: pings only.
+static void link_to_death(JNIEnv*, jobject) {}
+
+#endif
+
+static void mark_down(uint64_t now) {
+    g_down_since_ns.store(now, std::memory_order_relaxed);
+    g_known_down.store(true, std::memory_order_relaxed);
+    g_outages.fetch_add(1, std::memory_order_relaxed);
+    logw("watchdog: murasaki daemon unreachable");
+}
+
+static void mark_recovered(uint64_t now) {
+    uint64_t recovery = now - g_down_since_ns.load(std::memory_order_relaxed);
+    g_downtime_ns.fetch_add(recovery, std::memory_order_relaxed);
+    g_last_recovery_ns.store(recovery, std::memory_order_relaxed);
+    if (recovery > g_max_recovery_ns.load(std::memory_order_relaxed)) {
+        g_max_recovery_ns.store(recovery, std::memory_order_relaxed);  // single writer
+    }
+    g_known_down.store(false, std::memory_order_relaxed);
+    logd("watchdog: murasaki daemon back after %llums", (unsigned long long) (recovery / 1000000));
+}
+
+static void watchdog_main() {
+    JNIEnv* env = attachDaemonThread(g_vm, "MurasakiWatchdog");
+    if (!env) {
+        logw("watchdog: AttachCurrentThread failed");
+        return;
+    }
+    wait_for(kStartupGraceMs);
+
+    bool first = true;
+    uint32_t backoff_ms = kRelaunchBackoffMinMs;
+    uint64_t next_launch_ns = 0;
+    for (;;) {
+        // 长驻线程：每轮用局部帧回收本轮产生的 local ref
+        if (env->PushLocalFrame(16) != JNI_OK) {
+            env->ExceptionClear();
+            wait_for(kDownProbeIntervalMs);
+            continue;
+        }
+        jobject binder;
+        {
+            ScopedTrace trace("watchdog:probe");
+            binder = g_probe(env);
+        }
+        if (binder) {
+            link_to_death(env, binder);
+            // New binder identity = new daemon instance, whether or not a ping saw it down.
+            // Before clearing the outage, so the recovery time covers the refreshed grants too
+            if (!g_last_binder || !env->IsSameObject(g_last_binder, binder)) {
+                if (g_last_binder) env->DeleteGlobalRef(g_last_binder);
+                g_last_binder = env->NewGlobalRef(binder);
+                g_recovered(env, binder);
+            }
+        }
+        env->PopLocalFrame(nullptr);
+        g_tick();
+
+        uint64_t now = monotonicNs();
+        g_pings.fetch_add(1, std::memory_order_relaxed);
+        if (binder) {
+            if (g_known_down.load(std::memory_order_relaxed)) {
+                mark_recovered(now);
+            }
+            g_up.store(true, std::memory_order_relaxed);
+            first = false;
+            backoff_ms = kRelaunchBackoffMinMs;
+            wait_for(kPingIntervalMs);
+            continue;
+        }
+
+        g_ping_failures.fetch_add(1, std::memory_order_relaxed);
+        if (first || g_up.load(std::memory_order_relaxed)) {
+            g_up.store(false, std::memory_order_relaxed);
+            first = false;
+            mark_down(now);
+            next_launch_ns = now;
+        }
+        if (now >= next_launch_ns) {
+            ScopedTrace trace("watchdog:relaunch");
+            g_launch();
+            g_relaunches.fetch_add(1, std::memory_order_relaxed);
+            next_launch_ns = now + backoff_ms * 1000000ull;
+            backoff_ms = std::min(backoff_ms * 2, kRelaunchBackoffMaxMs);
+        }
+        wait_for(kDownProbeIntervalMs);
+    }
+}
+
+void daemonWatchdogStart(JavaVM* vm, DaemonProbe probe, DaemonLaunch launch, DaemonRecovered recovered,
+                         WatchdogTick tick) {
+    std::call_once(g_watchdog_once, [&] {
+        g_vm = vm;
+        g_probe = probe;
+        g_launch = launch;
+        g_recovered = recovered;
+        g_tick = tick;
+        std::thread(watchdog_main).detach();
+    });
+}
+
+DaemonState daemonState() {
+    if (g_up.load(std::memory_order_relaxed)) return DaemonState::Up;
+    return g_known_down.load(std::memory_order_relaxed) ? DaemonState::Down : DaemonState::Unknown;
+}
+
+bool daemonKnownDown() {
+    return g_known_down.load(std::memory_order_relaxed);
+}
+
+DaemonHealth daemonHealth() {
+    DaemonHealth h;
+    h.up = g_up.load(std::memory_order_relaxed);
+    h.outages = g_outages.load(std::memory_order_relaxed);
+    h.relaunches = g_relaunches.load(std::memory_order_relaxed);
+    h.pings = g_pings.load(std::memory_order_relaxed);
+    h.ping_failures = g_ping_failures.load(std::memory_order_relaxed);
+    uint64_t downtime = g_downtime_ns.load(std::memory_order_relaxed);
+    if (g_known_down.load(std::memory_order_relaxed)) {
+        downtime += monotonicNs() - g_down_since_ns.load(std::memory_order_relaxed);
+    }
+    h.downtime_ms = downtime / 1000000;
+    h.last_recovery_ms = g_last_recovery_ns.load(std::memory_order_relaxed) / 1000000;
+    h.max_recovery_ms = g_max_recovery_ns.load(std::memory_order_relaxed) / 1000000;
+    return h;
+}
+
+void logDaemonHealth() {
+    DaemonHealth h = daemonHealth();
+    logd("daemon health: up=%d outages=%u relaunches=%u pings=%llu failures=%llu downtime=%llums "
+         "recovery last=%llums max=%llums",
+         h.up ? 1 : 0, h.outages, h.relaunches, (unsigned long long) h.pings, (unsigned long long) h.ping_failures,
+         (unsigned long long) h.downtime_ms, (unsigned long long) h.last_recovery_ms,
+         (unsigned long long) h.max_recovery_ms);
+}
+
+}  // namespace murasaki::bridge
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <jni.h>
+
+#include <cstdint>
+
+namespace murasaki::bridge {
+
+// Background thread that keeps the Murasaki daemon binder resolved. It pings the daemon
+// periodically (and wakes at once on binder death on device), relaunches the daemon with
+// exponential backoff while it is unreachable, and re-resolves the binder so client requests
+// find it already cached.
+
+// Returns a local ref to a live (pinged) daemon binder, or null. Called on the watchdog thread.
+using DaemonProbe = jobject (*)(JNIEnv* env);
+using DaemonLaunch = void (*)();
+// Called on the watchdog thread with the probed binder whenever it differs from the previous one:
+// the daemon came back after an outage or restarted between two pings.
+using DaemonRecovered = void (*)(JNIEnv* env, jobject binder);
+// Housekeeping run on the watchdog thread once per round (every ping or down probe), so periodic
+// bridge work stays off binder threads.
+using WatchdogTick = void (*)();
+
+// Starts the thread once; later calls are ignored.
+void daemonWatchdogStart(JavaVM* vm, DaemonProbe probe, DaemonLaunch launch, DaemonRecovered recovered,
+                         WatchdogTick tick);
+
+enum class DaemonState : uint8_t {
+    Unknown = 0,  // watchdog not started or still in its startup grace period
+    Up,
+    Down,
+};
+
+// Last state seen by the watchdog; two relaxed loads, no IPC.
+DaemonState daemonState();
+
+// True while the watchdog has the daemon marked unreachable. Binder threads then try once
+// instead of sleeping through the retry budget; the watchdog is already relaunching it.
+bool daemonKnownDown();
+
+struct DaemonHealth {
+    bool up = false;
+    uint32_t outages = 0;
+    uint32_t relaunches = 0;
+    uint64_t pings = 0;
+    uint64_t ping_failures = 0;
+    uint64_t downtime_ms = 0;        // all outages, including the current one
+    uint64_t last_recovery_ms = 0;   // outage detected -> binder resolved again
+    uint64_t max_recovery_ms = 0;
+};
+
+DaemonHealth daemonHealth();
+void logDaemonHealth();
+
+}  // namespace murasaki::bridge
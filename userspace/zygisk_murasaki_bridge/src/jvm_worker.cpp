@@ -0,0 +1,98 @@
+#include "jvm_worker.hpp"
+
+#include <atomic>
+#include <deque>
+#include <thread>
+
+#include "log.hpp"
+
+namespace murasaki::bridge {
+
+// 并行鉴权的辅助线程数；全部忙碌时提交方直接在 binder 线程内联执行
+static constexpr int kJvmWorkers = 4;
+
+// Never destroyed: helpers block on the condition variable for the life of the process.
+struct WorkQueue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<JvmTask*> tasks;
+};
+
+static std::once_flag g_pool_once;
+static JavaVM* g_vm = nullptr;
+static WorkQueue* g_queue = nullptr;
+static std::atomic<int> g_idle{0};
+
+// Android's jni.h takes JNIEnv** here, the JDK's (host bench) void**.
+template <typename EnvOut>
+static EnvOut attach_env_arg(jint (JavaVM::*)(EnvOut, void*));
+
+JNIEnv* attachDaemonThread(JavaVM* vm, const char* name) {
+    using EnvOut = decltype(attach_env_arg(&JavaVM::AttachCurrentThreadAsDaemon));
+    JavaVMAttachArgs args{JNI_VERSION_1_6, const_cast<char*>(name), nullptr};
+    JNIEnv* env = nullptr;
+    if (vm->AttachCurrentThreadAsDaemon(reinterpret_cast<EnvOut>(&env), &args) != JNI_OK) {
+        return nullptr;
+    }
+    return env;
+}
+
+static void worker_main() {
+    JNIEnv* env = attachDaemonThread(g_vm, "MurasakiAuth");
+    if (!env) {
+        logw("jvm worker: AttachCurrentThread failed");
+        return;
+    }
+    for (;;) {
+        g_idle.fetch_add(1, std::memory_order_release);
+        JvmTask* task;
+        {
+            std::unique_lock<std::mutex> lock(g_queue->mutex);
+            g_queue->cv.wait(lock, [] { return !g_queue->tasks.empty(); });
+            task = g_queue->tasks.front();
+            g_queue->tasks.pop_front();
+        }
+        if (env->PushLocalFrame(16) == JNI_OK) {
+            task->fn(env, task->arg);
+            env->PopLocalFrame(nullptr);
+        } else {
+            env->ExceptionClear();
+            task->fn(env, task->arg);
+        }
+        // Read before done: without release the submitter owns the task and frees it once it sees done
+        auto release = task->release;
+        {
+            // Notify under the lock for the same reason
+            std::lock_guard<std::mutex> lock(task->mutex);
+            task->done = true;
+            task->cv.notify_one();
+        }
+        if (release) release(env, task);
+    }
+}
+
+bool jvmWorkerTrySubmit(JNIEnv* env, JvmTask* task) {
+    std::call_once(g_pool_once, [env] {
+        if (env->GetJavaVM(&g_vm) != JNI_OK || !g_vm) {
+            logw("jvm worker: GetJavaVM failed, running inline");
+            return;
+        }
+        g_queue = new WorkQueue();
+        for (int i = 0; i < kJvmWorkers; ++i) {
+            std::thread(worker_main).detach();
+        }
+    });
+    // Claim an idle helper first, so a submitted task never waits in the queue
+    int idle = g_idle.load(std::memory_order_acquire);
+    do {
+        if (idle <= 0) return false;
+    } while (!g_idle.compare_exchange_weak(idle, idle - 1, std::memory_order_acq_rel));
+    {
+        std::lock_guard<std::mutex> lock(g_queue->mutex);
+        g_queue->tasks.push_back(task);
+    }
+    g_queue->cv.notify_one();
+    return true;
+}
+
+}  // namespace murasaki::bridge
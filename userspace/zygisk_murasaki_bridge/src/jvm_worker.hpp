@@ -0,0 +1,36 @@
+#pragma once
+
+#include <jni.h>
+
+#include <condition_variable>
+#include <mutex>
+
+namespace murasaki::bridge {
+
+// Attaches the calling native thread to the VM as a daemon thread; null on failure.
+JNIEnv* attachDaemonThread(JavaVM* vm, const char* name);
+
+// One JNI call run on a helper thread while the submitting binder thread does other work.
+// fn runs inside its own local frame: local refs must not escape (hand back global refs).
+// A submitter that may stop waiting heap-allocates the task and sets release, which the helper
+// calls once it no longer touches the task (the two sides then share ownership, e.g. a refcount).
+struct JvmTask {
+    void (*fn)(JNIEnv* env, void* arg) = nullptr;
+    void* arg = nullptr;
+    void (*release)(JNIEnv* env, JvmTask* task) = nullptr;
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return done; });
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+// Hands `task` to an idle helper (the small pool starts on first use). Returns false when every
+// helper is busy, so under a boot storm callers simply run the work inline; never queues.
+bool jvmWorkerTrySubmit(JNIEnv* env, JvmTask* task);
+
+}  // namespace murasaki::bridge
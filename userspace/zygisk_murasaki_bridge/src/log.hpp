@@ -0,0 +1,73 @@
+#pragma once
+
+#if defined(__ANDROID__)
+#include <android/log.h>
+#else
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+#include <atomic>
+#include <cstdarg>
+
+namespace murasaki::bridge {
+
+static constexpr const char* LOG_TAG = "MurasakiBridge";
+
+enum LogLevel : int {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_WARN = 1,
+    LOG_LEVEL_SILENT = 2,
+};
+
+// Set from the bridge config (log_level=debug|warn|silent).
+inline std::atomic<int> g_log_level{LOG_LEVEL_DEBUG};
+
+#if defined(__ANDROID__)
+
+static inline void logd(const char* fmt, ...) {
+    if (g_log_level.load(std::memory_order_relaxed) > LOG_LEVEL_DEBUG) return;
+    va_list ap;
+    va_start(ap, fmt);
+    __android_log_vprint(ANDROID_LOG_DEBUG, LOG_TAG, fmt, ap);
+    va_end(ap);
+}
+
+static inline void logw(const char* fmt, ...) {
+    if (g_log_level.load(std::memory_order_relaxed) > LOG_LEVEL_WARN) return;
+    va_list ap;
+    va_start(ap, fmt);
+    __android_log_vprint(ANDROID_LOG_WARN, LOG_TAG, fmt, ap);
+    va_end(ap);
+}
+
+#else
+
+// Host builds (bench/): stderr, only when MURASAKI_BRIDGE_LOG is set so benchmarks stay quiet.
+static inline void host_vlog(char level, const char* fmt, va_list ap) {
+    static const bool enabled = getenv("MURASAKI_BRIDGE_LOG") != nullptr;
+    if (!enabled) return;
+    fprintf(stderr, "%c/%s: ", level, LOG_TAG);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+}
+
+static inline void logd(const char* fmt, ...) {
+    if (g_log_level.load(std::memory_order_relaxed) > LOG_LEVEL_DEBUG) return;
+    va_list ap;
+    va_start(ap, fmt);
+    host_vlog('D', fmt, ap);
+    va_end(ap);
+}
+
+static inline void logw(const char* fmt, ...) {
+    if (g_log_level.load(std::memory_order_relaxed) > LOG_LEVEL_WARN) return;
+    va_list ap;
+    va_start(ap, fmt);
+    host_vlog('W', fmt, ap);
+    va_end(ap);
+}
+
+#endif
+
+}  // namespace murasaki::bridge
@@ -27,6 +27,9 @@ public:
         }
 
         // Hook android.os.Binder#execTransact(IJJI)Z in system_server only (same as Sui's Binder hook).
+        // It is the narrowest hook available: hookJniNativeMethods can only replace native methods, and
+        // the per-service onTransact overrides (e.g. IActivityManager$Stub) are bytecode. Other
+        // transactions pay one compare on the code before the original runs.
         JNINativeMethod m[] = {
             {"execTransact", "(IJJI)Z", (void*)murasaki::bridge::execTransact},
         };
@@ -43,6 +46,9 @@ public:
         (void)args;
         // 启动时拉起 reid daemon（reid services / apd services / ksud services），供桥接向声明了 Murasaki/Shizuku 的 app 注入 Binder
         murasaki::bridge::startReidDaemonIfNeeded();
+        if (env_) {
+            murasaki::bridge::startDaemonWatchdog(env_);
+        }
     }
 
 private:
@@ -0,0 +1,262 @@
+#include "session_cache.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include "auth_pipeline.hpp"
+#include "config.hpp"
+#include "log.hpp"
+
+namespace murasaki::bridge {
+
+// TTL (session_ttl_ms) bounds how long a revoked grant keeps working; slots are session_slots.
+static constexpr size_t kSessionProbe = 8;
+// 后台线程清理已退出进程与过期条目的最小间隔
+static constexpr uint64_t kSweepIntervalNs = 5000000000ull;  // 5s
+
+struct SessionEntry {
+    int pid = 0;
+    int uid = -1;
+    uint64_t start_time = 0;  // /proc/<pid>/stat field 22, clock ticks since boot
+    uint64_t granted_ns = 0;
+    uint32_t passed = 0;
+};
+
+static std::mutex g_session_mutex;
+static SessionEntry g_sessions[kMaxSessionSlots];
+static uint64_t g_last_sweep_ns = 0;  // sweeping thread only
+
+static std::atomic<uint64_t> g_session_hits{0};
+static std::atomic<uint64_t> g_session_misses{0};
+static std::atomic<uint64_t> g_session_evictions{0};
+
+#if defined(__ANDROID__)
+
+// Returns 0 when the process is gone or /proc is unreadable.
+static uint64_t read_start_time(int pid) {
+    char path[32];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE* f = fopen(path, "re");
+    if (!f) return 0;
+    char buf[512];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+
+    // comm (field 2) may contain spaces and ')' — fields resume after the last ')'
+    char* p = strrchr(buf, ')');
+    if (!p) return 0;
+    ++p;
+    // field 3 (state) .. field 22 (starttime)
+    for (int field = 3; field < 22; ++field) {
+        p = strchr(p + 1, ' ');
+        if (!p) return 0;
+    }
+    return strtoull(p + 1, nullptr, 10);
+}
+
+#else
+
+// Host builds (bench/): callers are synthetic pids, so the stand-in world answers instead of the
+// host's /proc (bench/fake_jni.cpp).
+uint64_t hostProcessStartTime(int pid);
+
+static uint64_t read_start_time(int pid) {
+    return hostProcessStartTime(pid);
+}
+
+#endif
+
+// Taken from the config by the first lookup or store and never changed: entries sit at
+// slot_of(pid, slots), so resizing under them would strand them (session_slots is restart-only).
+static std::atomic<size_t> g_slot_count{0};
+
+static size_t slot_count(const BridgeConfig& cfg) {
+    size_t n = g_slot_count.load(std::memory_order_relaxed);
+    if (n != 0) return n;
+    size_t want = cfg.session_slots;
+    return g_slot_count.compare_exchange_strong(n, want, std::memory_order_relaxed) ? want : n;
+}
+
+// session_ttl_ms of the latest lookup/store snapshot, for the status peek, which reads no config
+static std::atomic<uint64_t> g_ttl_ns{0};
+
+static void note_ttl(uint64_t ttl_ns) {
+    if (g_ttl_ns.load(std::memory_order_relaxed) != ttl_ns) g_ttl_ns.store(ttl_ns, std::memory_order_relaxed);
+}
+
+static size_t slot_of(int pid, size_t slots) {
+    return (static_cast<uint32_t>(pid) * 2654435761u) % slots;
+}
+
+static bool same_entry(const SessionEntry& a, const SessionEntry& b) {
+    return a.pid == b.pid && a.start_time == b.start_time && a.granted_ns == b.granted_ns;
+}
+
+// Drops the entry in `slot` unless it was replaced since `seen` was copied out of it.
+static void evict_if_unchanged(size_t slot, const SessionEntry& seen) {
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    SessionEntry& e = g_sessions[slot];
+    if (same_entry(e, seen)) {
+        e = SessionEntry{};
+        g_session_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool sessionCacheLookup(const BridgeConfig& cfg, int pid, int uid, uint32_t required) {
+    uint64_t ttl_ns = cfg.session_ttl_ms * 1000000ull;
+    note_ttl(ttl_ns);
+    if (pid <= 0 || ttl_ns == 0) return false;
+    size_t slots = slot_count(cfg);
+    uint64_t now = monotonicNs();
+
+    size_t slot = kMaxSessionSlots;
+    SessionEntry candidate;
+    {
+        std::lock_guard<std::mutex> lock(g_session_mutex);
+        size_t base = slot_of(pid, slots);
+        for (size_t i = 0; i < kSessionProbe; ++i) {
+            size_t idx = (base + i) % slots;
+            SessionEntry& e = g_sessions[idx];
+            if (e.pid != pid) continue;
+            if (now - e.granted_ns >= ttl_ns) {
+                e = SessionEntry{};
+                g_session_evictions.fetch_add(1, std::memory_order_relaxed);
+            } else if (e.uid == uid && (e.passed & required) == required) {
+                slot = idx;
+                candidate = e;
+            }
+            break;
+        }
+    }
+    // Only a candidate hit reads /proc, outside the lock: the entry must still be the same process
+    if (slot != kMaxSessionSlots) {
+        uint64_t start_time = read_start_time(pid);
+        if (start_time != 0 && start_time == candidate.start_time) {
+            g_session_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        // 进程已退出或 pid 被复用
+        evict_if_unchanged(slot, candidate);
+    }
+    g_session_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void sessionCacheStore(const BridgeConfig& cfg, int pid, int uid, uint32_t passed_stages) {
+    note_ttl(cfg.session_ttl_ms * 1000000ull);
+    if (pid <= 0 || cfg.session_ttl_ms == 0) return;
+    size_t slots = slot_count(cfg);
+    uint64_t start_time = read_start_time(pid);
+    if (start_time == 0) return;
+    uint64_t now = monotonicNs();
+
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    size_t base = slot_of(pid, slots);
+    SessionEntry* target = nullptr;
+    for (size_t i = 0; i < kSessionProbe; ++i) {
+        SessionEntry& e = g_sessions[(base + i) % slots];
+        if (e.pid == pid || e.pid == 0) {
+            target = &e;
+            break;
+        }
+        if (!target || e.granted_ns < target->granted_ns) {
+            target = &e;  // probe window full: replace the oldest
+        }
+    }
+    target->pid = pid;
+    target->uid = uid;
+    target->start_time = start_time;
+    target->granted_ns = now;
+    target->passed = passed_stages;
+}
+
+void sessionCacheSweep() {
+    uint64_t now = monotonicNs();
+    if (g_last_sweep_ns != 0 && now - g_last_sweep_ns < kSweepIntervalNs) return;
+    g_last_sweep_ns = now;
+    uint64_t ttl_ns = configCurrent()->session_ttl_ms * 1000000ull;
+
+    struct Candidate {
+        size_t slot;
+        SessionEntry entry;
+    };
+    std::vector<Candidate> live;
+    {
+        std::lock_guard<std::mutex> lock(g_session_mutex);
+        for (size_t i = 0; i < kMaxSessionSlots; ++i) {
+            SessionEntry& e = g_sessions[i];
+            if (e.pid == 0) continue;
+            if (now - e.granted_ns >= ttl_ns) {
+                e = SessionEntry{};
+                g_session_evictions.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                live.push_back({i, e});
+            }
+        }
+    }
+    // /proc is read outside g_session_mutex so lookups on binder threads never wait for the walk
+    for (const Candidate& c : live) {
+        if (read_start_time(c.entry.pid) != c.entry.start_time) evict_if_unchanged(c.slot, c.entry);
+    }
+}
+
+bool sessionCachePeek(int pid, int uid, uint32_t required, uint32_t* remaining_ms) {
+    uint64_t ttl_ns = g_ttl_ns.load(std::memory_order_relaxed);
+    if (pid <= 0 || ttl_ns == 0) return false;
+    size_t slots = g_slot_count.load(std::memory_order_relaxed);
+    if (slots == 0) return false;  // nothing stored yet
+    uint64_t now = monotonicNs();
+
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    size_t base = slot_of(pid, slots);
+    for (size_t i = 0; i < kSessionProbe; ++i) {
+        const SessionEntry& e = g_sessions[(base + i) % slots];
+        if (e.pid != pid) continue;
+        uint64_t age = now - e.granted_ns;
+        if (e.uid != uid || age >= ttl_ns || (e.passed & required) != required) return false;
+        *remaining_ms = static_cast<uint32_t>((ttl_ns - age) / 1000000);
+        return true;
+    }
+    return false;
+}
+
+size_t sessionCacheUids(int* uids, size_t max_uids) {
+    ConfigRef cfg = configCurrent();
+    uint64_t ttl_ns = cfg->session_ttl_ms * 1000000ull;
+    uint64_t now = monotonicNs();
+    size_t n = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_session_mutex);
+        for (const SessionEntry& e : g_sessions) {
+            if (n == max_uids) break;
+            if (e.pid != 0 && now - e.granted_ns < ttl_ns) uids[n++] = e.uid;
+        }
+    }
+    std::sort(uids, uids + n);
+    return static_cast<size_t>(std::unique(uids, uids + n) - uids);
+}
+
+void sessionCacheEvictUid(int uid) {
+    std::lock_guard<std::mutex> lock(g_session_mutex);
+    for (SessionEntry& e : g_sessions) {
+        if (e.pid != 0 && e.uid == uid) {
+            e = SessionEntry{};
+            g_session_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void logSessionCacheStats() {
+    logd("session cache: hits=%llu misses=%llu evictions=%llu",
+         (unsigned long long) g_session_hits.load(std::memory_order_relaxed),
+         (unsigned long long) g_session_misses.load(std::memory_order_relaxed),
+         (unsigned long long) g_session_evictions.load(std::memory_order_relaxed));
+}
+
+}  // namespace murasaki::bridge
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "config.hpp"
+
+namespace murasaki::bridge {
+
+// Recent successful authorizations keyed by (pid, process start time, uid). The start time read
+// from /proc/<pid>/stat makes a recycled pid miss, and entries of dead processes are dropped.
+// Reconnects from the same live process within session_ttl_ms (config) skip the auth pipeline.
+
+// True when (pid, uid) holds a live entry whose passed stages cover `required`. `cfg` is the
+// request's snapshot, so lookup and store agree with the auth pipeline on the TTL.
+bool sessionCacheLookup(const BridgeConfig& cfg, int pid, int uid, uint32_t required);
+
+void sessionCacheStore(const BridgeConfig& cfg, int pid, int uid, uint32_t passed_stages);
+
+// Lookup for status queries: in-memory only (no config or /proc read, no eviction, not counted in
+// stats). The TTL is the one the last lookup or store saw, and a recycled pid of the same uid may
+// still report the previous process's entry.
+// On a hit *remaining_ms is the TTL left.
+bool sessionCachePeek(int pid, int uid, uint32_t required, uint32_t* remaining_ms);
+
+// Distinct uids of unexpired entries (at most max_uids), for re-checking their daemon grants in bulk.
+size_t sessionCacheUids(int* uids, size_t max_uids);
+
+// Drops every entry of `uid`, e.g. after the daemon revoked its grant.
+void sessionCacheEvictUid(int uid);
+
+// Drops expired entries and those of exited processes (one /proc read per live entry). Runs on
+// the watchdog thread, at most every few seconds, so binder threads never pay for the walk.
+void sessionCacheSweep();
+
+void logSessionCacheStats();
+
+}  // namespace murasaki::bridge
@@ -0,0 +1,147 @@
+#include "trace.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#if defined(__ANDROID__)
+#include <sys/system_properties.h>
+#else
+#include <sys/syscall.h>
+#endif
+
+#include "auth_pipeline.hpp"
+#include "log.hpp"
+
+namespace murasaki::bridge {
+
+#if defined(__ANDROID__)
+
+// Same property and tag bit libcutils/android.os.Trace use for ATRACE_TAG_ACTIVITY_MANAGER
+static constexpr const char* kAtraceTagsProperty = "debug.atrace.tags.enableflags";
+static constexpr uint64_t kAtraceTagActivityManager = 1ull << 6;
+// 属性尚未创建时（从未开启过 atrace）最多每秒查找一次
+static constexpr uint64_t kPropertyFindIntervalNs = 1000000000ull;
+
+static std::atomic<const prop_info*> g_tags_prop{nullptr};
+static std::atomic<uint32_t> g_tags_serial{~0u};
+static std::atomic<uint64_t> g_next_find_ns{0};
+
+static std::once_flag g_marker_once;
+static int g_marker_fd = -1;
+
+static bool open_marker() {
+    std::call_once(g_marker_once, [] {
+        g_marker_fd = open("/sys/kernel/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+        if (g_marker_fd < 0) {
+            g_marker_fd = open("/sys/kernel/debug/tracing/trace_marker", O_WRONLY | O_CLOEXEC);
+        }
+        if (g_marker_fd < 0) {
+            logw("trace: cannot open trace_marker");
+        }
+    });
+    return g_marker_fd >= 0;
+}
+
+static void read_tags(void* cookie, const char*, const char* value, uint32_t) {
+    *static_cast<uint64_t*>(cookie) = strtoull(value, nullptr, 0);
+}
+
+void traceRefresh() {
+    const prop_info* pi = g_tags_prop.load(std::memory_order_acquire);
+    if (!pi) {
+        uint64_t now = monotonicNs();
+        uint64_t next = g_next_find_ns.load(std::memory_order_relaxed);
+        if (now < next ||
+            !g_next_find_ns.compare_exchange_strong(next, now + kPropertyFindIntervalNs, std::memory_order_relaxed)) {
+            return;
+        }
+        pi = __system_property_find(kAtraceTagsProperty);
+        if (!pi) return;
+        g_tags_prop.store(pi, std::memory_order_release);
+    }
+    // The serial changes on every property write; re-read the value only then. Load first so the
+    // common unchanged case never writes the shared line; the CAS lets one thread do the re-read.
+    uint32_t serial = __system_property_serial(pi);
+    uint32_t seen = g_tags_serial.load(std::memory_order_relaxed);
+    if (seen == serial || !g_tags_serial.compare_exchange_strong(seen, serial, std::memory_order_relaxed)) return;
+
+    uint64_t tags = 0;
+    __system_property_read_callback(pi, read_tags, &tags);
+    bool on = (tags & kAtraceTagActivityManager) != 0 && open_marker();
+    g_trace_enabled.store(on, std::memory_order_relaxed);
+}
+
+uint64_t traceBegin(const char* name) {
+    char buf[128];
+    int n = snprintf(buf, sizeof(buf), "B|%d|%s", getpid(), name);
+    if (n > 0) {
+        (void)write(g_marker_fd, buf, n < static_cast<int>(sizeof(buf)) ? n : sizeof(buf) - 1);
+    }
+    return 0;
+}
+
+void traceEnd(const char*, uint64_t) {
+    char buf[24];
+    int n = snprintf(buf, sizeof(buf), "E|%d", getpid());
+    if (n > 0) {
+        (void)write(g_marker_fd, buf, n);
+    }
+}
+
+#else
+
+// Chrome trace event format (JSON array of complete "X" events); open in Perfetto UI or
+// chrome://tracing. Names are compile-time literals, so no JSON escaping is done.
+static std::once_flag g_trace_once;
+static std::mutex g_trace_mutex;
+static FILE* g_trace_file = nullptr;
+static bool g_trace_first = true;
+
+static void host_close() {
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    g_trace_enabled.store(false, std::memory_order_relaxed);
+    if (!g_trace_file) return;
+    fputs("\n]\n", g_trace_file);
+    fclose(g_trace_file);
+    g_trace_file = nullptr;
+}
+
+static void host_open() {
+    const char* path = getenv("MURASAKI_BRIDGE_TRACE");
+    if (!path || !*path) return;
+    g_trace_file = fopen(path, "we");
+    if (!g_trace_file) {
+        logw("trace: cannot open %s", path);
+        return;
+    }
+    fputc('[', g_trace_file);
+    atexit(host_close);
+    g_trace_enabled.store(true, std::memory_order_relaxed);
+}
+
+void traceRefresh() {
+    std::call_once(g_trace_once, host_open);
+}
+
+uint64_t traceBegin(const char*) {
+    return monotonicNs();
+}
+
+void traceEnd(const char* name, uint64_t begin_ns) {
+    uint64_t end_ns = monotonicNs();
+    static thread_local const long tid = syscall(SYS_gettid);
+    std::lock_guard<std::mutex> lock(g_trace_mutex);
+    if (!g_trace_file) return;
+    fprintf(g_trace_file, "%s{\"name\":\"%s\",\"cat\":\"bridge\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld}",
+            g_trace_first ? "\n" : ",\n", name, begin_ns / 1000.0, (end_ns - begin_ns) / 1000.0,
+            static_cast<int>(getpid()), tid);
+    g_trace_first = false;
+}
+
+#endif
+
+}  // namespace murasaki::bridge
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace murasaki::bridge {
+
+// Scoped trace markers. On device they are written to the kernel trace_marker while the atrace
+// "am" category is enabled, so bridge stages show up as slices under Binder.execTransact in
+// Perfetto/systrace. Host builds (bench/) write Chrome-trace JSON to $MURASAKI_BRIDGE_TRACE.
+// With tracing off a marker costs one relaxed atomic load.
+inline std::atomic<bool> g_trace_enabled{false};
+
+// Re-evaluate g_trace_enabled (atrace tag property on device). Called once per MRSK request that
+// needs authorization; status queries skip it and trace with the last value.
+void traceRefresh();
+
+// Use ScopedTrace; these are only valid while g_trace_enabled was observed true.
+uint64_t traceBegin(const char* name);
+void traceEnd(const char* name, uint64_t begin_ns);
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char* name) : name_(name) {
+        if (g_trace_enabled.load(std::memory_order_relaxed)) {
+            active_ = true;
+            begin_ns_ = traceBegin(name);
+        }
+    }
+
+    ~ScopedTrace() {
+        if (active_) traceEnd(name_, begin_ns_);
+    }
+
+    ScopedTrace(const ScopedTrace&) = delete;
+    ScopedTrace& operator=(const ScopedTrace&) = delete;
+
+private:
+    const char* name_;
+    uint64_t begin_ns_ = 0;
+    bool active_ = false;
+};
+
+}  // namespace murasaki::bridge
@@ -0,0 +1,123 @@
+// Reader for the bridge audit log.
+//
+//   murasaki_audit [-u uid] [-v verdict-prefix] [-s] [file...]
+//
+// Without files it reads audit.log.1 then audit.log from /data/system/murasaki_bridge, oldest first.
+// -s prints per-uid/verdict counts and average latency instead of the records.
+
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../src/audit_log.hpp"
+
+using namespace murasaki::bridge;
+
+namespace {
+
+struct Filter {
+    bool by_uid = false;
+    int uid = -1;
+    const char* verdict = nullptr;
+};
+
+struct Summary {
+    uint64_t count = 0;
+    uint64_t latency_us = 0;
+    std::string package;
+};
+
+bool matches(const Filter& f, const AuditRecord& r) {
+    if (f.by_uid && r.uid != f.uid) return false;
+    if (f.verdict && strncmp(auditVerdictName(r.verdict), f.verdict, strlen(f.verdict)) != 0) return false;
+    return true;
+}
+
+void print_record(const AuditRecord& r, const char* package) {
+    time_t secs = static_cast<time_t>(r.time_ms / 1000);
+    struct tm tm;
+    localtime_r(&secs, &tm);
+    char when[32];
+    strftime(when, sizeof(when), "%m-%d %H:%M:%S", &tm);
+    printf("%s.%03d  uid=%-6d pid=%-6d action=%d  %-16s %7uus  %s\n", when, static_cast<int>(r.time_ms % 1000), r.uid,
+           r.pid, r.action, auditVerdictName(r.verdict), r.latency_us, package);
+}
+
+int usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [-u uid] [-v verdict-prefix] [-s] [file...]\n", argv0);
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Filter filter;
+    bool summary = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "u:v:s")) != -1) {
+        switch (opt) {
+            case 'u':
+                filter.by_uid = true;
+                filter.uid = atoi(optarg);
+                break;
+            case 'v':
+                filter.verdict = optarg;
+                break;
+            case 's':
+                summary = true;
+                break;
+            default:
+                return usage(argv[0]);
+        }
+    }
+
+    std::vector<const char*> files(argv + optind, argv + argc);
+    if (files.empty()) {
+        files = {AUDIT_LOG_ROTATED_PATH, AUDIT_LOG_PATH};
+    }
+
+    std::map<std::pair<int, AuditVerdict>, Summary> totals;
+    char line[512];
+    char package[256];
+    size_t malformed = 0;
+    for (const char* path : files) {
+        FILE* f = fopen(path, "re");
+        if (!f) continue;
+        while (fgets(line, sizeof(line), f)) {
+            AuditRecord r;
+            if (!parseAuditLine(line, &r, package, sizeof(package))) {
+                ++malformed;
+                continue;
+            }
+            if (!matches(filter, r)) continue;
+            if (summary) {
+                Summary& s = totals[{r.uid, r.verdict}];
+                ++s.count;
+                s.latency_us += r.latency_us;
+                s.package = package;
+            } else {
+                print_record(r, package);
+            }
+        }
+        fclose(f);
+    }
+
+    if (summary) {
+        printf("%-7s %-16s %8s %10s  %s\n", "uid", "verdict", "count", "avg(us)", "package");
+        for (const auto& [key, s] : totals) {
+            printf("%-7d %-16s %8llu %10llu  %s\n", key.first, auditVerdictName(key.second),
+                   (unsigned long long) s.count, (unsigned long long) (s.latency_us / s.count), s.package.c_str());
+        }
+    }
+    if (malformed) {
+        fprintf(stderr, "skipped %zu malformed lines\n", malformed);
+    }
+    return 0;
+}